@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Generates large synthetic blink programs for the benchmarks.
+
+    python3 bench/gen.py <workload> [scale] > program.blink
+
+Every workload grows linearly with scale, which defaults to 1.
+"""
+
+import sys
+
+
+def definitions(scale):
+    """Many functions and variables, each defined and used once."""
+    n = 20000 * scale
+    out = []
+
+    for i in range(n):
+        out.append('var v%d = %d;' % (i, i))
+        out.append('String s%d = "value %d";' % (i, i))
+        out.append('fn f%d(a, b) { var c = a * %d + b; c; };' % (i, i))
+
+    for i in range(n):
+        out.append('f%d(v%d, %d);' % (i, i, i % 7))
+
+    return out
+
+
+def calls(scale):
+    """Chains of nested calls that are not in tail position, so that
+    every call keeps its frame until the whole chain returns."""
+    depth = 1000
+    out = []
+
+    for i in range(depth):
+        out.append('fn c%d(x) { c%d(x + 1); x; };' % (i, i + 1))
+
+    out.append('fn c%d(x) { x; };' % depth)
+
+    # A binary tree of calls runs the chain once per leaf.
+    levels = 9 + scale.bit_length()
+
+    for i in range(levels):
+        out.append('fn t%d(x) { t%d(x); t%d(x); };' % (i, i + 1, i + 1))
+
+    out.append('fn t%d(x) { c0(x); };' % levels)
+    out.append('t0(0);')
+
+    return out
+
+
+def strings(scale):
+    """Long string literals, bound to variables and printed once."""
+    n = 2000 * scale
+    text = 'the quick brown fox jumps over the lazy dog ' * 25
+    out = []
+
+    for i in range(n):
+        out.append('String s%d = "%d %s";' % (i, i, text))
+
+    for i in range(0, n, 100):
+        out.append('print(s%d);' % i)
+
+    return out
+
+
+def output(scale):
+    """Heavy print output from a binary tree of calls, mixing strings,
+    integers and floats."""
+    levels = 16 + scale.bit_length()
+    out = []
+
+    for i in range(levels):
+        out.append('fn p%d(x) { p%d(x + 1); p%d(x * 2); };' % (i, i + 1, i + 1))
+
+    out.append('fn p%d(x) { print("line", x, x / 4); };' % levels)
+    out.append('p0(1);')
+
+    return out
+
+
+WORKLOADS = {
+    'definitions': definitions,
+    'calls': calls,
+    'strings': strings,
+    'output': output,
+}
+
+
+def generate(workload, scale=1):
+    return '\n'.join(WORKLOADS[workload](scale)) + '\n'
+
+
+def main():
+    if len(sys.argv) not in (2, 3) or sys.argv[1] not in WORKLOADS:
+        sys.exit('usage: gen.py <%s> [scale]' % '|'.join(WORKLOADS))
+
+    scale = int(sys.argv[2]) if len(sys.argv) == 3 else 1
+    sys.stdout.write(generate(sys.argv[1], scale))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,488 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../src/include/lexer.h"
+#include "../src/include/parser.h"
+#include "../src/include/scope.h"
+#include "../src/include/runtime.h"
+#include "../src/include/resolver.h"
+#include "../src/include/folder.h"
+
+#define MICROBENCH_WARMUP 3
+#define MICROBENCH_REPEAT 10
+
+/* Definitions of the generated source that is lexed and parsed. */
+#define MICROBENCH_SOURCE_DEFINITIONS 20000
+
+/* Lookups of one repetition of the scope benchmarks. */
+#define MICROBENCH_LOOKUPS (1 << 20)
+
+/* Levels of the call tree and reads of the leaf function that the
+   dispatch benchmark runs, one visit of the walker for each read. */
+#define MICROBENCH_DISPATCH_LEVELS 12
+#define MICROBENCH_DISPATCH_READS 64
+
+/* A component benchmark. Setup and teardown run once around every
+   repetition, only run is timed and returns how many operations it
+   performed. */
+typedef struct MICROBENCH_STRUCT
+{
+    const char* name;
+    const char* unit;
+    void (*setup)(struct MICROBENCH_STRUCT* bench);
+    size_t (*run)(struct MICROBENCH_STRUCT* bench);
+    void (*teardown)(struct MICROBENCH_STRUCT* bench);
+
+    /* Size of the scope for the scope benchmarks. */
+    size_t size;
+
+    arena_T* arena;
+    scope_T* scope;
+    const char** names;
+    char* program;
+    runtime_T* runtime;
+    AST_T* call;
+} microbench_T;
+
+/* Operations per second of every timed repetition. */
+typedef struct MICROBENCH_RESULT_STRUCT
+{
+    double mean;
+    double stddev;
+    double min;
+    double max;
+} microbench_result_T;
+
+static char* source;
+static size_t source_length;
+
+/**
+ * @brief Reads the monotonic clock.
+ *
+ * @return seconds Returns the time in seconds.
+ */
+static double microbench_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Generates the source that is lexed and parsed, a mix of
+ *        variable, string and function definitions and calls.
+ *
+ * @return void Does not return.
+ */
+static void microbench_generate_source() {
+    size_t capacity = MICROBENCH_SOURCE_DEFINITIONS * 160;
+    source = malloc(capacity);
+    source_length = 0;
+
+    for (size_t i = 0; i < MICROBENCH_SOURCE_DEFINITIONS; i++) {
+        source_length += snprintf(
+            source + source_length,
+            capacity - source_length,
+            "var v%zu = %zu;\n"
+            "String s%zu = \"value %zu\";\n"
+            "fn f%zu(a, b) { var c = a * %zu + b; c; };\n"
+            "f%zu(v%zu, %zu);\n",
+            i, i, i, i, i, i, i, i, i % 7
+        );
+    }
+}
+
+/**
+ * @brief Counts the nodes of a tree.
+ *
+ * @param[in] node Pointer to the root of the tree.
+ * @return size Returns the amount of nodes.
+ */
+static size_t microbench_count_nodes(AST_T* node) {
+    size_t count = 1;
+
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            return count + microbench_count_nodes(node->var_def_value);
+        }
+        case AST_FUNCTION_DEFINITION: {
+            for (size_t i = 0; i < node->fn_def_args_size; i++) {
+                count += microbench_count_nodes(node->fn_def_args[i]);
+            }
+
+            return count + microbench_count_nodes(node->fn_def_body);
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                count += microbench_count_nodes(node->fn_call_args[i]);
+            }
+
+            return count;
+        }
+        case AST_BINARY: {
+            return count
+                + microbench_count_nodes(node->binary_left)
+                + microbench_count_nodes(node->binary_right);
+        }
+        case AST_NEGATE: {
+            return count + microbench_count_nodes(node->negate_value);
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                count += microbench_count_nodes(node->compound_value[i]);
+            }
+
+            return count;
+        }
+        default: {
+            return count;
+        }
+    }
+}
+
+/**
+ * @brief Scans every token of the source.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return size Returns the amount of tokens.
+ */
+static size_t microbench_run_lexer(microbench_T* bench) {
+    (void) bench;
+    arena_T* arena = init_arena(0);
+    lexer_T* lexer = init_lexer(source, source_length, arena, init_interner(arena));
+    size_t tokens = 0;
+    token_T* token;
+
+    while ((token = lexer_get_next_token(lexer))->type != TOKEN_EOF) {
+        lexer_release_token(lexer, token);
+        tokens++;
+    }
+
+    arena_free(arena);
+
+    return tokens;
+}
+
+/**
+ * @brief Parses the source.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return size Returns the amount of parsed nodes.
+ */
+static size_t microbench_run_parser(microbench_T* bench) {
+    (void) bench;
+    arena_T* arena = init_arena(0);
+    lexer_T* lexer = init_lexer(source, source_length, arena, init_interner(arena));
+    parser_T* parser = init_parser(lexer);
+    size_t nodes = microbench_count_nodes(parser_parse(parser, parser->scope));
+
+    arena_free(arena);
+
+    return nodes;
+}
+
+/**
+ * @brief Fills a scope with as many variable and function
+ *        definitions as the size of the benchmark.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return void Does not return.
+ */
+static void microbench_setup_scope(microbench_T* bench) {
+    bench->arena = init_arena(0);
+    bench->scope = init_scope(bench->arena);
+    bench->names = arena_alloc(bench->arena, bench->size * sizeof(char*));
+
+    interner_T* interner = init_interner(bench->arena);
+    char name[32];
+
+    for (size_t i = 0; i < bench->size; i++) {
+        int length = snprintf(name, sizeof(name), "name%zu", i);
+        bench->names[i] = interner_intern(interner, name, length);
+
+        AST_T* vdef = init_ast(bench->arena, AST_VARIABLE_DEFINITION);
+        vdef->var_def_var_name = bench->names[i];
+        scope_add_var_def(bench->scope, vdef);
+
+        AST_T* fdef = init_ast_list(bench->arena, AST_FUNCTION_DEFINITION, 0);
+        fdef->fn_def_name = bench->names[i];
+        scope_add_fn_def(bench->scope, fdef);
+    }
+}
+
+/**
+ * @brief Releases the scope of the benchmark.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return void Does not return.
+ */
+static void microbench_teardown_scope(microbench_T* bench) {
+    arena_free(bench->arena);
+}
+
+/**
+ * @brief Looks up variable definitions of the scope, every name
+ *        is in the scope.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return size Returns the amount of lookups.
+ */
+static size_t microbench_run_var_lookup(microbench_T* bench) {
+    size_t found = 0;
+
+    for (size_t i = 0; i < MICROBENCH_LOOKUPS; i++) {
+        found += scope_get_var_def(bench->scope, bench->names[(i * 7919) % bench->size]) != NULL;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Looks up function definitions of the scope, every name
+ *        is in the scope.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return size Returns the amount of lookups.
+ */
+static size_t microbench_run_fn_lookup(microbench_T* bench) {
+    size_t found = 0;
+
+    for (size_t i = 0; i < MICROBENCH_LOOKUPS; i++) {
+        found += scope_get_fn_def(bench->scope, bench->names[(i * 7919) % bench->size]) != NULL;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Prepares a program whose last statement calls a tree of
+ *        functions, with a leaf that only reads its argument. Every
+ *        other statement runs, so that only the call is left to time.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return void Does not return.
+ */
+static void microbench_setup_dispatch(microbench_T* bench) {
+    size_t capacity = 4096;
+    char* program = malloc(capacity);
+    size_t length = snprintf(program, capacity, "fn leaf(x) {");
+
+    for (size_t i = 0; i < MICROBENCH_DISPATCH_READS; i++) {
+        length += snprintf(program + length, capacity - length, " x;");
+    }
+
+    length += snprintf(program + length, capacity - length, " };\n");
+
+    for (size_t i = 0; i < MICROBENCH_DISPATCH_LEVELS; i++) {
+        length += snprintf(
+            program + length,
+            capacity - length,
+            "fn t%zu(x) { t%zu(x); t%zu(x); };\n",
+            i, i + 1, i + 1
+        );
+    }
+
+    length += snprintf(
+        program + length,
+        capacity - length,
+        "fn t%d(x) { leaf(x); };\nt0(1);\n",
+        MICROBENCH_DISPATCH_LEVELS
+    );
+
+    runtime_T* runtime = init_runtime();
+    lexer_T* lexer = init_lexer(program, length, runtime->arena, runtime->interner);
+    parser_T* parser = init_parser(lexer);
+    AST_T* root = parser_parse(parser, parser->scope);
+    resolver_resolve(init_resolver(runtime, parser->scope), root);
+    folder_fold(init_folder(runtime), root);
+
+    // The statements end with an empty one behind the call.
+    size_t size = root->compound_size;
+
+    while (root->compound_value[size - 1]->type != AST_FUNCTION_CALL) {
+        size--;
+    }
+
+    for (size_t i = 0; i < size - 1; i++) {
+        runtime_visit(runtime, root->compound_value[i]);
+    }
+
+    bench->runtime = runtime;
+    bench->call = root->compound_value[size - 1];
+    bench->program = program;
+}
+
+/**
+ * @brief Releases the runtime and program of the dispatch benchmark.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return void Does not return.
+ */
+static void microbench_teardown_dispatch(microbench_T* bench) {
+    runtime_free(bench->runtime);
+    free(bench->program);
+}
+
+/**
+ * @brief Visits the call of the prepared program.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @return size Returns the amount of reads of the leaf function.
+ */
+static size_t microbench_run_dispatch(microbench_T* bench) {
+    runtime_visit(bench->runtime, bench->call);
+
+    return ((size_t) 1 << MICROBENCH_DISPATCH_LEVELS) * MICROBENCH_DISPATCH_READS;
+}
+
+/**
+ * @brief Runs the warmup and the timed repetitions of a benchmark.
+ *
+ * @param[in] bench Pointer to the benchmark.
+ * @param[in] warmup Amount of repetitions that are not timed.
+ * @param[in] repeat Amount of timed repetitions.
+ * @return result Returns the operations per second of the repetitions.
+ */
+static microbench_result_T microbench_measure(microbench_T* bench, size_t warmup, size_t repeat) {
+    microbench_result_T result = { 0, 0, INFINITY, 0 };
+    double* rates = malloc(repeat * sizeof(double));
+
+    for (size_t i = 0; i < warmup + repeat; i++) {
+        if (bench->setup) {
+            bench->setup(bench);
+        }
+
+        double start = microbench_now();
+        size_t operations = bench->run(bench);
+        double elapsed = microbench_now() - start;
+
+        if (bench->teardown) {
+            bench->teardown(bench);
+        }
+
+        if (i >= warmup) {
+            rates[i - warmup] = operations / elapsed;
+        }
+    }
+
+    for (size_t i = 0; i < repeat; i++) {
+        result.mean += rates[i] / repeat;
+        result.min = fmin(result.min, rates[i]);
+        result.max = fmax(result.max, rates[i]);
+    }
+
+    for (size_t i = 0; i < repeat; i++) {
+        result.stddev += (rates[i] - result.mean) * (rates[i] - result.mean);
+    }
+
+    result.stddev = repeat > 1 ? sqrt(result.stddev / (repeat - 1)) : 0;
+    free(rates);
+
+    return result;
+}
+
+/**
+ * @brief Print help for running the microbenchmarks.
+ *
+ * @param[in] NONE
+ * @return int Returns 0 on successful run.
+ */
+void print_help() {
+    printf(
+        "Usage:\nmicrobench.out [options] [filter]\n"
+        "  --warmup <runs>           untimed runs of every benchmark\n"
+        "  --repeat <runs>           timed runs of every benchmark\n"
+        "  --json                    report the results as JSON\n"
+        "Only benchmarks whose name contains the filter run.\n"
+    );
+    exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    size_t warmup = MICROBENCH_WARMUP;
+    size_t repeat = MICROBENCH_REPEAT;
+    int json = 0;
+    const char* filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        char* end = "";
+
+        if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            warmup = strtoul(argv[++i], &end, 10);
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = strtoul(argv[++i], &end, 10);
+        else if (strcmp(argv[i], "--json") == 0)
+            json = 1;
+        else if (filter == NULL)
+            filter = argv[i];
+        else
+            print_help();
+
+        if (*end != '\0' || repeat == 0)
+            print_help();
+    }
+
+    microbench_T benches[] = {
+        { .name = "lexer_get_next_token", .unit = "tokens", .run = microbench_run_lexer },
+        { .name = "parser_parse", .unit = "nodes", .run = microbench_run_parser },
+        { .name = "scope_get_var_def/16", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_var_lookup, .teardown = microbench_teardown_scope, .size = 16 },
+        { .name = "scope_get_var_def/256", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_var_lookup, .teardown = microbench_teardown_scope, .size = 256 },
+        { .name = "scope_get_var_def/4096", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_var_lookup, .teardown = microbench_teardown_scope, .size = 4096 },
+        { .name = "scope_get_var_def/65536", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_var_lookup, .teardown = microbench_teardown_scope, .size = 65536 },
+        { .name = "scope_get_fn_def/16", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_fn_lookup, .teardown = microbench_teardown_scope, .size = 16 },
+        { .name = "scope_get_fn_def/256", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_fn_lookup, .teardown = microbench_teardown_scope, .size = 256 },
+        { .name = "scope_get_fn_def/4096", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_fn_lookup, .teardown = microbench_teardown_scope, .size = 4096 },
+        { .name = "scope_get_fn_def/65536", .unit = "lookups", .setup = microbench_setup_scope, .run = microbench_run_fn_lookup, .teardown = microbench_teardown_scope, .size = 65536 },
+        { .name = "runtime_visit", .unit = "visits", .setup = microbench_setup_dispatch, .run = microbench_run_dispatch, .teardown = microbench_teardown_dispatch },
+    };
+    size_t size = sizeof(benches) / sizeof(benches[0]);
+
+    microbench_generate_source();
+
+    if (json) {
+        printf("{\n  \"warmup\": %zu,\n  \"repeat\": %zu,\n  \"benchmarks\": [", warmup, repeat);
+    } else {
+        printf("%-24s %-8s %14s %12s %7s %14s %14s %10s\n",
+            "benchmark", "unit", "mean/s", "stddev/s", "cv", "min/s", "max/s", "ns/op");
+    }
+
+    int first = 1;
+
+    for (size_t i = 0; i < size; i++) {
+        microbench_T* bench = &benches[i];
+
+        if (filter != NULL && strstr(bench->name, filter) == NULL) {
+            continue;
+        }
+
+        microbench_result_T result = microbench_measure(bench, warmup, repeat);
+
+        if (json) {
+            printf(
+                "%s\n    { \"name\": \"%s\", \"unit\": \"%s\", \"mean\": %.1f,"
+                " \"stddev\": %.1f, \"min\": %.1f, \"max\": %.1f }",
+                first ? "" : ",",
+                bench->name, bench->unit,
+                result.mean, result.stddev, result.min, result.max
+            );
+        } else {
+            printf("%-24s %-8s %14.0f %12.0f %6.2f%% %14.0f %14.0f %10.2f\n",
+                bench->name, bench->unit,
+                result.mean, result.stddev, 100 * result.stddev / result.mean,
+                result.min, result.max, 1e9 / result.mean);
+        }
+
+        fflush(stdout);
+        first = 0;
+    }
+
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+
+    free(source);
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""Runs the benchmark workloads and reports the results as JSON.
+
+    python3 bench/run.py [--scale N] [--repeat N] [--output FILE] <blink>
+
+Each workload is generated by gen.py and run in four modes: --lex-only,
+--parse-only, on the tree-walker and on the VM. Every mode runs repeat
+times, the fastest wall time and the largest peak RSS are kept. The time
+of a phase is the fastest of the phase timings blink reports with
+--stats-json, so lex throughput covers reading and scanning the source,
+parse throughput the parser, resolver and folder, and execution the run
+of the program alone, compiling included on the VM. Process startup is
+measured on an empty program. The peak RSS is the one blink reports,
+which unlike the rusage of the child does not count the runner itself.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+import gen
+
+MODES = {
+    'lex': ['--lex-only'],
+    'parse': ['--parse-only'],
+    'walker': [],
+    'vm': ['--vm'],
+}
+
+
+# Phases of --stats-json that make up each mode's phase of interest.
+PHASES = {
+    'lex': ['read', 'lex'],
+    'parse': ['parse', 'resolve', 'fold'],
+    'walker': ['run'],
+    'vm': ['compile', 'run'],
+}
+
+# Phase timings are in nanoseconds, a phase is never reported faster.
+RESOLUTION = 1e-9
+
+
+def measure(command, repeat, phases):
+    """Runs the command repeat times, returns the fastest wall time in
+    seconds, the largest peak RSS in kilobytes and the fastest time in
+    seconds of the phases blink reports."""
+    best = None
+    best_phases = None
+    peak = 0
+
+    for _ in range(repeat):
+        start = time.perf_counter()
+        process = subprocess.run(
+            command[:1] + ['--stats-json'] + command[1:],
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.PIPE,
+        )
+        elapsed = time.perf_counter() - start
+
+        if process.returncode != 0:
+            sys.exit('%s exited with %d' % (' '.join(command), process.returncode))
+
+        stats = json.loads(process.stderr)
+        seconds = sum(
+            stats['phases'][phase]['wall_seconds']
+            for phase in phases
+            if phase in stats['phases']
+        )
+        best = elapsed if best is None else min(best, elapsed)
+        best_phases = seconds if best_phases is None else min(best_phases, seconds)
+        peak = max(peak, stats['peak_rss_kb'])
+
+    return best, peak, max(best_phases, RESOLUTION)
+
+
+def throughput(size, seconds):
+    return round(size / seconds)
+
+
+def run(blink, scale, repeat):
+    results = {
+        'binary': blink,
+        'scale': scale,
+        'repeat': repeat,
+        'workloads': {},
+    }
+
+    with tempfile.TemporaryDirectory() as directory:
+        empty = os.path.join(directory, 'empty.blink')
+        open(empty, 'w').close()
+        startup, _, _ = measure([blink] + MODES['lex'] + [empty], repeat, [])
+        results['startup_seconds'] = startup
+
+        for workload in gen.WORKLOADS:
+            path = os.path.join(directory, workload + '.blink')
+
+            with open(path, 'w') as f:
+                f.write(gen.generate(workload, scale))
+
+            size = os.path.getsize(path)
+            times = {}
+            rss = {}
+            phases = {}
+
+            for mode, args in MODES.items():
+                times[mode], rss[mode], phases[mode] = measure(
+                    [blink] + args + [path], repeat, PHASES[mode])
+
+            results['workloads'][workload] = {
+                'bytes': size,
+                'lex': {
+                    'seconds': phases['lex'],
+                    'bytes_per_second': throughput(size, phases['lex']),
+                    'peak_rss_kb': rss['lex'],
+                },
+                'parse': {
+                    'seconds': phases['parse'],
+                    'bytes_per_second': throughput(size, phases['parse']),
+                    'peak_rss_kb': rss['parse'],
+                },
+                'walker': {
+                    'seconds': phases['walker'],
+                    'total_seconds': times['walker'],
+                    'peak_rss_kb': rss['walker'],
+                },
+                'vm': {
+                    'seconds': phases['vm'],
+                    'total_seconds': times['vm'],
+                    'peak_rss_kb': rss['vm'],
+                },
+            }
+
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('blink', help='path of the blink binary')
+    parser.add_argument('--scale', type=int, default=1)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--output', help='file to write the JSON to')
+    options = parser.parse_args()
+
+    results = run(os.path.abspath(options.blink), options.scale, options.repeat)
+    text = json.dumps(results, indent=2) + '\n'
+
+    if options.output:
+        with open(options.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Compares the latency of short runs on a server with cold runs.
+
+    python3 bench/serve.py [--scale N] [--requests N] [--output FILE] <blink>
+
+Every request runs the same one line program on top of a prelude, the
+definitions workload of gen.py, in four modes:
+
+    cold    a new process parses and runs the prelude and the program
+    image   a new process starts from an image of the prelude
+    client  blink --connect sends the program to a server started from
+            the image, so the latency includes starting the client
+    socket  the runner sends the request itself, the latency of the
+            server alone
+
+The latency of every mode is reported in milliseconds as JSON.
+"""
+
+import argparse
+import json
+import os
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+import gen
+
+PROGRAM = 'print(f1(v1, 2), s1);\n'
+
+
+def run_command(command):
+    process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+
+    if process.returncode != 0:
+        sys.exit('%s exited with %d' % (' '.join(command), process.returncode))
+
+    return process.stdout
+
+
+def run_socket(path, program):
+    """Sends a program as source and returns what it printed."""
+    output = []
+
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+        client.connect(path)
+        payload = program.encode()
+        client.sendall(b'S' + struct.pack('=I', len(payload)) + payload)
+        stream = client.makefile('rb')
+
+        while True:
+            header = stream.read(5)
+
+            if len(header) < 5:
+                sys.exit('lost connection to %s' % path)
+
+            length, = struct.unpack('=I', header[1:])
+            data = stream.read(length)
+
+            if header[:1] == b'O':
+                output.append(data)
+            elif header[:1] == b'X':
+                status, = struct.unpack('=I', data)
+
+                if status != 0:
+                    sys.exit('request exited with %d' % status)
+
+                return b''.join(output)
+
+
+def wait_for(path, server):
+    for _ in range(500):
+        if server.poll() is not None:
+            sys.exit('server exited with %d' % server.returncode)
+
+        try:
+            with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+                client.connect(path)
+                return
+        except OSError:
+            time.sleep(0.01)
+
+    sys.exit('server did not listen on %s' % path)
+
+
+def latencies(request, requests):
+    """Runs the request, returns its output and its latency in
+    milliseconds for every run."""
+    times = []
+    output = None
+
+    for _ in range(requests):
+        start = time.perf_counter()
+        result = request()
+        times.append((time.perf_counter() - start) * 1e3)
+
+        if output is not None and result != output:
+            sys.exit('output differs between runs')
+
+        output = result
+
+    return output, times
+
+
+def summary(times):
+    times = sorted(times)
+
+    def percentile(p):
+        return round(times[min(len(times) - 1, int(len(times) * p))], 3)
+
+    return {
+        'mean_ms': round(sum(times) / len(times), 3),
+        'min_ms': round(times[0], 3),
+        'p50_ms': percentile(0.5),
+        'p95_ms': percentile(0.95),
+        'p99_ms': percentile(0.99),
+    }
+
+
+def run(blink, scale, requests):
+    results = {
+        'binary': blink,
+        'scale': scale,
+        'requests': requests,
+        'modes': {},
+    }
+
+    with tempfile.TemporaryDirectory() as directory:
+        prelude = os.path.join(directory, 'prelude.blink')
+        program = os.path.join(directory, 'program.blink')
+        full = os.path.join(directory, 'full.blink')
+        image = os.path.join(directory, 'prelude.img')
+        path = os.path.join(directory, 'blink.sock')
+        source = gen.generate('definitions', scale)
+
+        with open(prelude, 'w') as f:
+            f.write(source)
+
+        with open(program, 'w') as f:
+            f.write(PROGRAM)
+
+        with open(full, 'w') as f:
+            f.write(source + PROGRAM)
+
+        run_command([blink, '--dump-image', image, prelude])
+        server = subprocess.Popen([blink, '--serve', path, '--image', image])
+
+        try:
+            wait_for(path, server)
+            modes = {
+                'cold': lambda: run_command([blink, full]),
+                'image': lambda: run_command([blink, '--image', image, program]),
+                'client': lambda: run_command([blink, '--connect', path, program]),
+                'socket': lambda: run_socket(path, PROGRAM),
+            }
+            outputs = set()
+
+            for mode, request in modes.items():
+                output, times = latencies(request, requests)
+                outputs.add(output)
+                results['modes'][mode] = summary(times)
+
+            if len(outputs) != 1:
+                sys.exit('output differs between modes')
+        finally:
+            server.terminate()
+            server.wait()
+
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('blink', help='path of the blink binary')
+    parser.add_argument('--scale', type=int, default=1)
+    parser.add_argument('--requests', type=int, default=50)
+    parser.add_argument('--output', help='file to write the JSON to')
+    options = parser.parse_args()
+
+    results = run(os.path.abspath(options.blink), options.scale, options.requests)
+    text = json.dumps(results, indent=2) + '\n'
+
+    if options.output:
+        with open(options.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
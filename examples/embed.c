@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <string.h>
+#include "blink.h"
+
+/**
+ * Host program that embeds the interpreter, built and run by
+ * make check-embed. Functions of an instance outlive the evaluation
+ * that defined them, so they must see the variables of the later
+ * evaluations that call them, and those must see what the functions
+ * assign.
+ */
+static value_T seen;
+
+static value_T see(struct RUNTIME_STRUCT* runtime, value_T* args, size_t args_size) {
+    (void) runtime;
+    (void) args_size;
+
+    seen = args[0];
+
+    return args[0];
+}
+
+static int eval(blink_T* blink, const char* program) {
+    if (!blink_eval_string(blink, program, strlen(program))) {
+        printf("Could not evaluate `%s`: %s\n", program, blink_error(blink));
+        return 0;
+    }
+
+    return 1;
+}
+
+static int saw(blink_T* blink, const char* program, int expected) {
+    seen = VALUE_UNDEFINED;
+
+    if (!eval(blink, program)) {
+        return 0;
+    }
+
+    if (!value_is_int(seen) || value_as_int(seen) != expected) {
+        printf("`%s` did not see %d\n", program, expected);
+        return 0;
+    }
+
+    return 1;
+}
+
+int main() {
+    blink_T* blink = init_blink();
+    blink_register(blink, "see", see, 1, 0);
+
+    int ok = saw(blink, "var k = 10; fn f() { see(k); }; f();", 10)
+        && saw(blink, "var k = 5; f();", 5)
+        && eval(blink, "fn setx() { var x = 5; };")
+        && saw(blink, "var x = 1; setx(); see(x);", 5);
+
+    seen = VALUE_UNDEFINED;
+
+    if (ok && (!blink_call(blink, "f", NULL, 0, NULL) || value_as_int(seen) != 5)) {
+        printf("blink_call of `f` did not see 5\n");
+        ok = 0;
+    }
+
+    blink_free(blink);
+
+    return ok ? 0 : 1;
+}
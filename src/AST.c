@@ -1,42 +1,165 @@
 #include "include/AST.h"
+#include <stddef.h>
+
+#define AST_SIZE(last) \
+    (offsetof(struct AST_STRUCT, last) + sizeof(((struct AST_STRUCT*) 0)->last))
+
+/* Size in bytes of a node of each type. */
+static const size_t ast_sizes[] = {
+    [AST_VARIABLE_DEFINITION] = AST_SIZE(var_def_index),
+    [AST_FUNCTION_DEFINITION] = AST_SIZE(fn_def_index),
+    [AST_VARIABLE] = AST_SIZE(var_index),
+    [AST_FUNCTION_CALL] = AST_SIZE(fn_call_version),
+    [AST_STRING] = AST_SIZE(string_value),
+    [AST_INTEGER] = AST_SIZE(integer_value),
+    [AST_FLOAT] = AST_SIZE(float_value),
+    [AST_BOOLEAN] = AST_SIZE(boolean_value),
+    [AST_BINARY] = AST_SIZE(binary_right),
+    [AST_NEGATE] = AST_SIZE(negate_value),
+    [AST_COMPOUND] = AST_SIZE(compound_size),
+    [AST_NOOP] = offsetof(struct AST_STRUCT, var_def_var_name),
+};
+
+const char* const ast_type_names[] = {
+    [AST_VARIABLE_DEFINITION] = "variable_definition",
+    [AST_FUNCTION_DEFINITION] = "function_definition",
+    [AST_VARIABLE] = "variable",
+    [AST_FUNCTION_CALL] = "function_call",
+    [AST_STRING] = "string",
+    [AST_INTEGER] = "integer",
+    [AST_FLOAT] = "float",
+    [AST_BOOLEAN] = "boolean",
+    [AST_BINARY] = "binary",
+    [AST_NEGATE] = "negate",
+    [AST_COMPOUND] = "compound",
+    [AST_NOOP] = "noop",
+};
 
 /**
  * @brief Initializes and allocates the abstract syntax tree by setting
  *        the type, and setting the remaining values to NULL or 0.
  * 
+ * @param[in] arena Pointer to the arena the node is allocated from.
  * @param[in] type Integer value of the node type.
  * @return parser Returns newly allocated abstract syntax tree.
  */
-AST_T* init_ast(int type) {
-    AST_T* ast = calloc(1, sizeof(struct AST_STRUCT));
-    ast->type = type;
+AST_T* init_ast(arena_T* arena, int type) {
+    return init_ast_list(arena, type, 0);
+}
 
-    ast->scope = NULL;
+/**
+ * @brief Initializes and allocates a function definition, function
+ *        call or compound node together with its list of child nodes.
+ *        The list is stored right behind the node and its size is set.
+ * 
+ * @param[in] arena Pointer to the arena the node is allocated from.
+ * @param[in] type Integer value of the node type.
+ * @param[in] size Amount of child nodes in the list.
+ * @return parser Returns newly allocated abstract syntax tree.
+ */
+AST_T* init_ast_list(arena_T* arena, int type, size_t size) {
+    // The arena hands out zeroed memory, so every field starts as NULL or 0.
+    size_t node_size = ast_node_size(type);
+    AST_T* ast = arena_alloc(arena, node_size + size * sizeof(struct AST_STRUCT*));
+    ast->type = type;
 
-    // AST_VARIABLE_DEFINITION
-    ast->var_def_var_name = NULL;
-    ast->var_def_value = NULL;
+    struct AST_STRUCT** list = (struct AST_STRUCT**) ((char*) ast + node_size);
 
-    // AST_FUNCTION_DEFINITION
-    ast->fn_def_body = NULL;
-    ast->fn_def_name = NULL;
-    ast->fn_def_args = NULL;
-    ast->fn_def_args_size = 0;
+    switch (type) {
+        case AST_FUNCTION_DEFINITION: {
+            ast->fn_def_args = list;
+            ast->fn_def_args_size = size;
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            ast->fn_call_args = list;
+            ast->fn_call_args_size = size;
+            break;
+        }
+        case AST_COMPOUND: {
+            ast->compound_value = list;
+            ast->compound_size = size;
+            break;
+        }
+    }
 
-    // AST_VARIABLE
-    ast->var_name = NULL;
+    return ast;
+}
 
-    // AST_FUNCTION_CALL
-    ast->fn_call_name = NULL;
-    ast->fn_call_args = NULL;
-    ast->fn_call_args_size = 0;
+/**
+ * @brief Gives the size of a node of a type, up to its list of child
+ *        nodes, which is aligned to hold pointers.
+ * 
+ * @param[in] type Integer value of the node type.
+ * @return size Returns the size in bytes of the node.
+ */
+size_t ast_node_size(int type) {
+    return (ast_sizes[type] + sizeof(struct AST_STRUCT*) - 1)
+        / sizeof(struct AST_STRUCT*) * sizeof(struct AST_STRUCT*);
+}
 
-    // AST_STRING
-    ast->string_value = NULL;
+/**
+ * @brief Initializes and allocates the literal node of a value.
+ *        Only strings, numbers and booleans have a literal.
+ * 
+ * @param[in] arena Pointer to the arena the node is allocated from.
+ * @param[in] value Value of the literal.
+ * @return parser Returns newly allocated abstract syntax tree.
+ */
+AST_T* init_ast_literal(arena_T* arena, value_T value) {
+    AST_T* ast;
 
-    // AST_COMPOUND
-    ast->compound_value = NULL;
-    ast->compound_size = 0;
+    if (value_is_string(value)) {
+        ast = init_ast(arena, AST_STRING);
+        ast->string_value = value_as_string(value);
+    } else if (value_is_int(value)) {
+        ast = init_ast(arena, AST_INTEGER);
+        ast->integer_value = value_as_int(value);
+    } else if (value_is_double(value)) {
+        ast = init_ast(arena, AST_FLOAT);
+        ast->float_value = value_as_double(value);
+    } else {
+        ast = init_ast(arena, AST_BOOLEAN);
+        ast->boolean_value = value == VALUE_TRUE;
+    }
 
     return ast;
 }
+
+/**
+ * @brief Tells whether the node is a string, number or boolean literal.
+ * 
+ * @param[in] node Pointer to the node.
+ * @return int Returns 1 for literals, 0 otherwise.
+ */
+int ast_is_literal(AST_T* node) {
+    switch (node->type) {
+        case AST_STRING:
+        case AST_INTEGER:
+        case AST_FLOAT:
+        case AST_BOOLEAN: {
+            return 1;
+        }
+        default: break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gives the value of a literal node.
+ * 
+ * @param[in] node Pointer to the literal node.
+ * @return value Returns the value of the literal.
+ */
+value_T ast_literal_value(AST_T* node) {
+    switch (node->type) {
+        case AST_STRING: return value_string(node->string_value);
+        case AST_INTEGER: return value_int(node->integer_value);
+        case AST_FLOAT: return value_double(node->float_value);
+        case AST_BOOLEAN: return value_bool(node->boolean_value);
+        default: break;
+    }
+
+    return VALUE_NIL;
+}
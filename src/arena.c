@@ -0,0 +1,174 @@
+#include "include/arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define ARENA_ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1))
+
+/**
+ * @brief Allocates a new block with room for at least size bytes.
+ * 
+ * @param[in] size Size in bytes of the data in the block.
+ * @return block Returns newly allocated block.
+ */
+static arena_block_T* init_arena_block(size_t size) {
+    arena_block_T* block = calloc(1, sizeof(struct ARENA_BLOCK_STRUCT) + size);
+
+    if (block == NULL) {
+        printf("Out of memory\n");
+        exit(1);
+    }
+
+    block->size = size;
+
+    return block;
+}
+
+/**
+ * @brief Initializes and allocates an arena. Memory is handed out
+ *        from large blocks by bumping a pointer and is only ever
+ *        released all at once by arena_reset or arena_free.
+ * 
+ * @param[in] block_size Size in bytes of each block, 0 for the default.
+ * @return arena Returns newly allocated arena.
+ */
+arena_T* init_arena(size_t block_size) {
+    arena_T* arena = calloc(1, sizeof(struct ARENA_STRUCT));
+    arena->block_size = block_size ? block_size : ARENA_BLOCK_SIZE;
+    arena->block = init_arena_block(arena->block_size);
+
+    return arena;
+}
+
+/**
+ * @brief Allocates zeroed memory from the arena. Allocations that
+ *        would waste most of a block get a block of their own.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @param[in] size Size in bytes of the allocation.
+ * @return ptr Returns pointer to the allocated memory.
+ */
+void* arena_alloc(arena_T* arena, size_t size) {
+    arena_block_T* block = arena->block;
+    size = ARENA_ALIGN(size);
+    arena->allocations++;
+    arena->allocated += size;
+
+    if (block->size - block->used < size) {
+        if (size > arena->block_size / 4) {
+            // Keep bumping the current block, put this one behind it.
+            arena_block_T* large = init_arena_block(size);
+            large->used = size;
+            large->prev = block->prev;
+            block->prev = large;
+
+            return large->data;
+        }
+
+        block = init_arena_block(arena->block_size);
+        block->prev = arena->block;
+        arena->block = block;
+    }
+
+    void* ptr = block->data + block->used;
+    block->used += size;
+
+    return ptr;
+}
+
+/**
+ * @brief Grows an allocation. The memory is extended in place when it
+ *        is the last allocation of the current block, otherwise it
+ *        is copied into a new allocation.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @param[in] ptr Pointer to the allocation, or NULL.
+ * @param[in] old_size Size in bytes of the allocation.
+ * @param[in] new_size Size in bytes the allocation needs.
+ * @return ptr Returns pointer to the grown allocation.
+ */
+void* arena_realloc(arena_T* arena, void* ptr, size_t old_size, size_t new_size) {
+    arena_block_T* block = arena->block;
+    old_size = ARENA_ALIGN(old_size);
+
+    if (ptr != NULL && new_size <= old_size) {
+        return ptr;
+    }
+
+    if (ptr != NULL && (char*) ptr + old_size == block->data + block->used) {
+        size_t grow = ARENA_ALIGN(new_size) - old_size;
+
+        if (block->size - block->used >= grow) {
+            block->used += grow;
+            arena->allocated += grow;
+            return ptr;
+        }
+    }
+
+    void* grown = arena_alloc(arena, new_size);
+
+    if (ptr != NULL) {
+        memcpy(grown, ptr, old_size < new_size ? old_size : new_size);
+    }
+
+    return grown;
+}
+
+/**
+ * @brief Copies a string of a given length into the arena
+ *        and NUL-terminates it.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @param[in] str String to copy.
+ * @param[in] length Amount of characters to copy.
+ * @return str Returns the copied String.
+ */
+char* arena_strndup(arena_T* arena, const char* str, size_t length) {
+    char* copy = arena_alloc(arena, length + 1);
+    memcpy(copy, str, length);
+
+    return copy;
+}
+
+/**
+ * @brief Releases everything allocated from the arena at once. The
+ *        first block is kept and zeroed as far as it was used, so the
+ *        arena can be reused without allocating and zeroing a block.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @return void Does not return.
+ */
+void arena_reset(arena_T* arena) {
+    arena_block_T* block = arena->block;
+
+    while (block->prev != NULL) {
+        arena_block_T* prev = block->prev;
+        free(block);
+        block = prev;
+    }
+
+    memset(block->data, 0, block->used);
+    block->used = 0;
+
+    arena->block = block;
+    arena->allocations = 0;
+    arena->allocated = 0;
+}
+
+/**
+ * @brief Releases every block of the arena and the arena itself.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @return void Does not return.
+ */
+void arena_free(arena_T* arena) {
+    arena_block_T* block = arena->block;
+
+    while (block != NULL) {
+        arena_block_T* prev = block->prev;
+        free(block);
+        block = prev;
+    }
+
+    free(arena);
+}
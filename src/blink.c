@@ -0,0 +1,236 @@
+#include "include/blink.h"
+#include <stdlib.h>
+#include <string.h>
+#include "include/lexer.h"
+#include "include/parser.h"
+#include "include/resolver.h"
+#include "include/folder.h"
+#include "include/io.h"
+
+/**
+ * @brief Initializes and allocates an interpreter instance with a
+ *        runtime of its own.
+ *
+ * @param[in] NONE
+ * @return blink Returns newly allocated instance.
+ */
+blink_T* init_blink() {
+    blink_T* blink = calloc(1, sizeof(struct BLINK_STRUCT));
+    blink->runtime = init_runtime();
+    blink->scope = init_scope(blink->runtime->arena);
+
+    return blink;
+}
+
+/**
+ * @brief Makes errors jump back to the host until blink_end.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] jump Jump set by the caller.
+ * @return void Does not return.
+ */
+static void blink_begin(blink_T* blink, jmp_buf* jump) {
+    error_T* error = &blink->runtime->error;
+    error->jump = jump;
+    error->message[0] = '\0';
+    error->count = 0;
+}
+
+/**
+ * @brief Writes what was printed and makes errors exit again.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return int Returns 1.
+ */
+static int blink_end(blink_T* blink) {
+    out_flush(blink->runtime->out);
+    blink->runtime->error.jump = NULL;
+
+    return 1;
+}
+
+/**
+ * @brief Unwinds the calls that were active when an error jumped
+ *        back to the host.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return int Returns 0.
+ */
+static int blink_fail(blink_T* blink) {
+    runtime_T* runtime = blink->runtime;
+    runtime->frames_size = 0;
+    runtime->slots_size = 0;
+    runtime->error.jump = NULL;
+
+    return 0;
+}
+
+/**
+ * @brief Evaluates a program in the instance. Its definitions stay
+ *        defined for later evaluations and calls.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] contents Characters of the program, not NUL-terminated.
+ * @param[in] length Amount of characters in the program.
+ * @return int Returns 1 when the program ran, 0 on an error.
+ */
+int blink_eval_string(blink_T* blink, const char* contents, size_t length) {
+    runtime_T* runtime = blink->runtime;
+    jmp_buf jump;
+
+    // Everything the evaluation allocates lives in the arena,
+    // so nothing is left to release when an error jumps here.
+    if (setjmp(jump) != 0) {
+        return blink_fail(blink);
+    }
+
+    blink_begin(blink, &jump);
+
+    lexer_T* lexer = init_lexer(contents, length, runtime->arena, runtime->interner);
+    lexer->error = &runtime->error;
+
+    AST_T* root = parser_parse(init_parser(lexer), blink->scope);
+    size_t first_global = runtime->globals.size;
+    resolver_resolve(init_resolver(runtime, blink->scope), root);
+
+    // Functions are called by later evaluations, which may define the
+    // variables they use again, and functions of earlier evaluations
+    // may define the variables of this one.
+    folder_T* folder = init_folder(runtime);
+    folder->first_global = first_global;
+    folder->persistent = 1;
+    folder_fold(folder, root);
+    runtime_run(runtime, root);
+
+    return blink_end(blink);
+}
+
+/**
+ * @brief Evaluates the program of a file in the instance.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] filepath String of path to source file.
+ * @return int Returns 1 when the program ran, 0 on an error.
+ */
+int blink_eval_file(blink_T* blink, const char* filepath) {
+    jmp_buf jump;
+
+    if (setjmp(jump) != 0) {
+        return blink_fail(blink);
+    }
+
+    blink_begin(blink, &jump);
+    source_T* source = read_file_source(filepath, &blink->runtime->error);
+    blink_end(blink);
+
+    int status = blink_eval_string(blink, source->contents, source->length);
+    source_free(source);
+
+    return status;
+}
+
+/**
+ * @brief Calls a function defined by an earlier evaluation.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] name String of the function name.
+ * @param[in] args Values of the arguments, strings from blink_string.
+ * @param[in] args_size Amount of arguments.
+ * @param[out] result Value of the call, or NULL.
+ * @return int Returns 1 when the function ran, 0 on an error.
+ */
+int blink_call(blink_T* blink, const char* name, value_T* args, size_t args_size, value_T* result) {
+    runtime_T* runtime = blink->runtime;
+    jmp_buf jump;
+
+    if (setjmp(jump) != 0) {
+        return blink_fail(blink);
+    }
+
+    blink_begin(blink, &jump);
+
+    const char* fname = interner_intern(runtime->interner, name, strlen(name));
+    AST_T* fdef = scope_get_fn_def(blink->scope, fname);
+    value_T function = fdef != NULL
+        ? runtime->functions.values[fdef->fn_def_index]
+        : VALUE_UNDEFINED;
+
+    // Declared by a program that failed before its definition ran.
+    if (function == VALUE_UNDEFINED) {
+        runtime_error(runtime, "Undefined method `%s`", fname);
+    }
+
+    value_T value = runtime_call(runtime, (AST_T*) value_as_function(function), args, args_size);
+
+    if (result != NULL) {
+        *result = value;
+    }
+
+    return blink_end(blink);
+}
+
+/**
+ * @brief Gives a string value of the instance. It stays valid until
+ *        the instance is reset or released.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] str String to intern.
+ * @param[in] length Amount of characters in the string.
+ * @return value Returns the string value.
+ */
+value_T blink_string(blink_T* blink, const char* str, size_t length) {
+    return value_string(interner_intern(blink->runtime->interner, str, length));
+}
+
+/**
+ * @brief Registers a native function that programs can call by name.
+ *        Only programs evaluated after the registration see it, and
+ *        it stays registered when the instance is reset. A native
+ *        reports an error with runtime_error.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] name String of the name the native is called by.
+ * @param[in] fn Pointer to the native function.
+ * @param[in] arity Amount of arguments, the least amount if variadic.
+ * @param[in] flags BUILTIN_VARIADIC or 0.
+ * @return void Does not return.
+ */
+void blink_register(blink_T* blink, const char* name, builtin_fn_T fn, size_t arity, int flags) {
+    runtime_register_builtin(blink->runtime, name, fn, arity, flags);
+}
+
+/**
+ * @brief Gives the message of the error of the last call that failed.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return message Returns the message, empty if there was none.
+ */
+const char* blink_error(blink_T* blink) {
+    return blink->runtime->error.message;
+}
+
+/**
+ * @brief Forgets every definition and value of the instance, keeping
+ *        the natives it registered and the configuration of its
+ *        runtime. Its memory is kept for the next programs, which
+ *        makes a reset much cheaper than a new instance.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return void Does not return.
+ */
+void blink_reset(blink_T* blink) {
+    runtime_reset(blink->runtime);
+    blink->scope = init_scope(blink->runtime->arena);
+}
+
+/**
+ * @brief Flushes what the programs printed and releases the runtime
+ *        of the instance and the instance itself.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return void Does not return.
+ */
+void blink_free(blink_T* blink) {
+    runtime_free(blink->runtime);
+    free(blink);
+}
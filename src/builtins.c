@@ -0,0 +1,66 @@
+#include "include/builtins.h"
+#include "include/runtime.h"
+
+/**
+ * @brief Registers the builtins every runtime starts with.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void builtins_register_defaults(runtime_T* runtime) {
+    runtime_register_builtin(runtime, "print", builtin_fn_print, 0, BUILTIN_VARIADIC);
+    runtime_register_builtin(runtime, "flush", builtin_fn_flush, 0, 0);
+}
+
+/**
+ * @brief Finds the builtin with the name.
+ * 
+ * @param[in] builtins Pointer to the builtins.
+ * @param[in] name Interned string of the name.
+ * @return index Returns the index of the builtin, or -1 if there is none.
+ */
+long builtins_find(builtins_T* builtins, const char* name) {
+    // Only the resolver looks builtins up, and there are few of them.
+    for (size_t i = 0; i < builtins->size; i++) {
+        if (builtins->entries[i].name == name) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Builtin for Blink's print function, prints every argument
+ *        on its own line.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] args Values of the arguments.
+ * @param[in] args_size Amount of arguments.
+ * @return value Returns nil.
+ */
+value_T builtin_fn_print(runtime_T* runtime, value_T* args, size_t args_size) {
+    for (size_t i = 0; i < args_size; i++) {
+        runtime_print_value(runtime, args[i]);
+    }
+
+    return VALUE_NIL;
+}
+
+/**
+ * @brief Builtin for Blink's flush function, writes everything
+ *        that was printed but is still buffered.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] args Values of the arguments.
+ * @param[in] args_size Amount of arguments.
+ * @return value Returns nil.
+ */
+value_T builtin_fn_flush(runtime_T* runtime, value_T* args, size_t args_size) {
+    (void) args;
+    (void) args_size;
+
+    out_flush(runtime->out);
+
+    return VALUE_NIL;
+}
@@ -0,0 +1,654 @@
+#include "include/cache.h"
+#include "include/intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define CACHE_STRINGS_CAPACITY 64
+
+/* Offset in the strings section of a name that is NULL, the name of
+   the top level. */
+#define CACHE_NO_STRING UINT64_MAX
+
+/* Bytes of the file or of its strings section while it is written. */
+typedef struct CACHE_BUFFER_STRUCT
+{
+    char* data;
+    size_t size;
+    size_t capacity;
+} cache_buffer_T;
+
+/* Open addressing map from interned strings to their offset in the
+   strings section, the capacity is a power of two. */
+typedef struct CACHE_STRINGS_STRUCT
+{
+    const char** keys;
+    uint64_t* offsets;
+    size_t size;
+    size_t capacity;
+    cache_buffer_T buffer;
+} cache_strings_T;
+
+/**
+ * @brief Hashes a source together with the version of the compiled
+ *        programs, the key of the compiled program of the source.
+ *
+ * @param[in] contents Characters of the source.
+ * @param[in] length Amount of characters in the source.
+ * @return key Returns the key of the source.
+ */
+uint64_t cache_key(const char* contents, size_t length) {
+    uint64_t key = intern_hash(contents, length);
+    key ^= CACHE_VERSION;
+    key *= 1099511628211ULL;
+
+    return key;
+}
+
+/**
+ * @brief Gives the path of the compiled program of a source. Without
+ *        a directory it lies next to the source, a .blink source gets
+ *        a .blinkc file. In a directory it is named after the key.
+ *
+ * @param[in] filename Path of the source.
+ * @param[in] dir Directory of compiled programs, or NULL.
+ * @param[in] key Key of the source.
+ * @return path Returns the newly allocated path.
+ */
+char* cache_path(const char* filename, const char* dir, uint64_t key) {
+    size_t length = (dir ? strlen(dir) : strlen(filename)) + 32;
+    char* path = malloc(length);
+
+    if (dir != NULL) {
+        snprintf(path, length, "%s/%016llx.blinkc", dir, (unsigned long long) key);
+    } else {
+        size_t size = strlen(filename);
+        int blink = size >= 6 && strcmp(filename + size - 6, ".blink") == 0;
+        snprintf(path, length, "%s%s", filename, blink ? "c" : ".blinkc");
+    }
+
+    return path;
+}
+
+/**
+ * @brief Makes room in a buffer for it to hold a size.
+ *
+ * @param[in] buffer Pointer to the buffer.
+ * @param[in] size Amount of bytes the buffer has to hold.
+ * @return void Does not return.
+ */
+static void cache_reserve(cache_buffer_T* buffer, size_t size) {
+    if (buffer->data != NULL && size <= buffer->capacity) {
+        return;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    buffer->data = realloc(buffer->data, capacity);
+    buffer->capacity = capacity;
+}
+
+/**
+ * @brief Appends bytes to a buffer, behind padding that aligns them
+ *        to 8 bytes.
+ *
+ * @param[in] buffer Pointer to the buffer.
+ * @param[in] data Bytes to append, or NULL for zeroes.
+ * @param[in] size Amount of bytes.
+ * @return offset Returns the offset of the bytes in the buffer.
+ */
+static uint64_t cache_append(cache_buffer_T* buffer, const void* data, size_t size) {
+    size_t offset = (buffer->size + 7) & ~(size_t) 7;
+    cache_reserve(buffer, offset + size);
+
+    memset(buffer->data + buffer->size, 0, offset - buffer->size);
+
+    if (data != NULL && size > 0) {
+        memcpy(buffer->data + offset, data, size);
+    } else {
+        memset(buffer->data + offset, 0, size);
+    }
+
+    buffer->size = offset + size;
+
+    return offset;
+}
+
+/**
+ * @brief Finds the slot of an interned string in the map of strings.
+ *
+ * @param[in] keys Keys of the map.
+ * @param[in] capacity Capacity of the map, a power of two.
+ * @param[in] str Interned string.
+ * @return index Returns the index of the slot holding the string,
+ *         or of the empty slot where it belongs.
+ */
+static size_t cache_strings_find(const char** keys, size_t capacity, const char* str) {
+    uint64_t hash = (uintptr_t) str * 11400714819323198485ULL;
+    size_t i = (hash ^ (hash >> 32)) & (capacity - 1);
+
+    while (keys[i] != NULL && keys[i] != str) {
+        i = (i + 1) & (capacity - 1);
+    }
+
+    return i;
+}
+
+/**
+ * @brief Gives the offset of a string in the strings section, adding
+ *        it on its first use.
+ *
+ * @param[in] strings Pointer to the strings map.
+ * @param[in] str Interned string, or NULL.
+ * @return offset Returns the offset of the string, or CACHE_NO_STRING.
+ */
+static uint64_t cache_string(cache_strings_T* strings, const char* str) {
+    if (str == NULL) {
+        return CACHE_NO_STRING;
+    }
+
+    if ((strings->size + 1) * 2 > strings->capacity) {
+        const char** keys = strings->keys;
+        uint64_t* offsets = strings->offsets;
+        size_t capacity = strings->capacity;
+
+        strings->capacity = capacity ? capacity * 2 : CACHE_STRINGS_CAPACITY;
+        strings->keys = calloc(strings->capacity, sizeof(char*));
+        strings->offsets = malloc(strings->capacity * sizeof(uint64_t));
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (keys[i] != NULL) {
+                size_t j = cache_strings_find(strings->keys, strings->capacity, keys[i]);
+                strings->keys[j] = keys[i];
+                strings->offsets[j] = offsets[i];
+            }
+        }
+
+        free(keys);
+        free(offsets);
+    }
+
+    size_t i = cache_strings_find(strings->keys, strings->capacity, str);
+
+    if (strings->keys[i] == NULL) {
+        strings->keys[i] = str;
+        strings->offsets[i] = strings->buffer.size;
+        strings->size += 1;
+
+        // Strings are packed, only sections are aligned.
+        size_t length = strlen(str) + 1;
+        cache_reserve(&strings->buffer, strings->buffer.size + length);
+        memcpy(strings->buffer.data + strings->buffer.size, str, length);
+        strings->buffer.size += length;
+    }
+
+    return strings->offsets[i];
+}
+
+/**
+ * @brief Appends the offsets of a list of names.
+ *
+ * @param[in] buffer Pointer to the buffer of the file.
+ * @param[in] strings Pointer to the strings map.
+ * @param[in] names Interned names.
+ * @param[in] size Amount of names.
+ * @return offset Returns the offset of the list in the file.
+ */
+static uint64_t cache_append_names(cache_buffer_T* buffer, cache_strings_T* strings, const char** names, size_t size) {
+    uint64_t offset = cache_append(buffer, NULL, size * sizeof(uint64_t));
+
+    for (size_t i = 0; i < size; i++) {
+        uint64_t name = cache_string(strings, names[i]);
+        memcpy(buffer->data + offset + i * sizeof(uint64_t), &name, sizeof(name));
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Writes the compiled program of a source, together with the
+ *        globals and builtins the runtime bound it to. The file is
+ *        replaced at once, so that no run maps a partly written one.
+ *        A program that cannot be written is compiled again next time.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] chunk Pointer to the compiled program.
+ * @param[in] path Path of the compiled program.
+ * @param[in] key Key of the source.
+ * @param[in] length Amount of characters in the source.
+ * @return void Does not return.
+ */
+void cache_store(runtime_T* runtime, chunk_T* chunk, const char* path, uint64_t key, size_t length) {
+    cache_buffer_T buffer = { 0 };
+    cache_strings_T strings = { 0 };
+    cache_header_T header = { 0 };
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER;
+    header.pointer_size = sizeof(void*);
+    header.source_hash = key;
+    header.source_length = length;
+
+    cache_append(&buffer, &header, sizeof(header));
+
+    header.code = cache_append(&buffer, chunk->code, chunk->code_size);
+    header.code_size = chunk->code_size;
+
+    header.constants = cache_append(&buffer, NULL, chunk->constants_size * sizeof(value_T));
+    header.constants_size = chunk->constants_size;
+
+    for (size_t i = 0; i < chunk->constants_size; i++) {
+        value_T value = chunk->constants[i];
+
+        if (value_is_string(value)) {
+            value = value_string((const char*) (uintptr_t) cache_string(&strings, value_as_string(value)));
+        }
+
+        memcpy(buffer.data + header.constants + i * sizeof(value_T), &value, sizeof(value));
+    }
+
+    header.functions = cache_append(&buffer, NULL, chunk->functions_size * sizeof(struct CHUNK_FUNCTION_STRUCT));
+    header.functions_size = chunk->functions_size;
+
+    for (size_t i = 0; i < chunk->functions_size; i++) {
+        chunk_function_T function = chunk->functions[i];
+        function.chunk = NULL;
+        function.name = (const char*) (uintptr_t) cache_string(&strings, function.name);
+
+        memcpy(
+            buffer.data + header.functions + i * sizeof(struct CHUNK_FUNCTION_STRUCT),
+            &function,
+            sizeof(function)
+        );
+    }
+
+    header.call_caches = cache_append(&buffer, NULL, chunk->call_caches_size * sizeof(struct CHUNK_CALL_CACHE_STRUCT));
+    header.call_caches_size = chunk->call_caches_size;
+
+    header.globals = cache_append_names(&buffer, &strings, runtime->globals.names, runtime->globals.size);
+    header.globals_size = runtime->globals.size;
+
+    header.function_globals = cache_append_names(&buffer, &strings, runtime->functions.names, runtime->functions.size);
+    header.function_globals_size = runtime->functions.size;
+
+    const char** builtins = malloc((runtime->builtins.size + 1) * sizeof(char*));
+
+    for (size_t i = 0; i < runtime->builtins.size; i++) {
+        builtins[i] = runtime->builtins.entries[i].name;
+    }
+
+    header.builtins = cache_append_names(&buffer, &strings, builtins, runtime->builtins.size);
+    header.builtins_size = runtime->builtins.size;
+    free(builtins);
+
+    header.strings = cache_append(&buffer, strings.buffer.data, strings.buffer.size);
+    header.strings_size = strings.buffer.size;
+
+    memcpy(buffer.data, &header, sizeof(header));
+
+    size_t tmp_length = strlen(path) + 32;
+    char* tmp = malloc(tmp_length);
+    snprintf(tmp, tmp_length, "%s.%ld.tmp", path, (long) getpid());
+
+    FILE* file = fopen(tmp, "wb");
+
+    if (file != NULL) {
+        int written = fwrite(buffer.data, 1, buffer.size, file) == buffer.size;
+
+        if (fclose(file) == 0 && written) {
+            rename(tmp, path);
+        }
+
+        unlink(tmp);
+    }
+
+    free(tmp);
+    free(buffer.data);
+    free(strings.buffer.data);
+    free(strings.keys);
+    free(strings.offsets);
+}
+
+/**
+ * @brief Checks that a section lies inside the file, after the
+ *        section before it, as they are written in order.
+ *
+ * @param[in] size Size in bytes of the file.
+ * @param[in,out] end End of the section before, moved to the end of
+ *                this one.
+ * @param[in] offset Offset of the section.
+ * @param[in] count Amount of elements of the section.
+ * @param[in] element_size Size in bytes of an element.
+ * @return int Returns 1 when the section fits, 0 otherwise.
+ */
+static int cache_fits(size_t size, size_t* end, uint64_t offset, uint64_t count, size_t element_size) {
+    if (offset % 8 != 0
+            || offset < *end
+            || offset > size
+            || count > (size - offset) / element_size) {
+        return 0;
+    }
+
+    *end = offset + count * element_size;
+
+    return 1;
+}
+
+/**
+ * @brief Gives a string of the strings section of a mapped program,
+ *        interned so that it is the same string as the one the
+ *        lexer or a builtin would give.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] map Start of the mapping.
+ * @param[in] header Pointer to the header of the program.
+ * @param[in] offset Offset of the string in the strings section.
+ * @return str Returns the string, or NULL when it does not lie
+ *         inside the strings section.
+ */
+static const char* cache_get_string(runtime_T* runtime, const char* map, cache_header_T* header, uint64_t offset) {
+    if (offset >= header->strings_size) {
+        return NULL;
+    }
+
+    const char* str = map + header->strings + offset;
+
+    const char* end = memchr(str, '\0', header->strings_size - offset);
+
+    if (end == NULL) {
+        return NULL;
+    }
+
+    return interner_intern(runtime->interner, str, end - str);
+}
+
+/**
+ * @brief Gives a name of a list of a mapped program.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] map Start of the mapping.
+ * @param[in] header Pointer to the header of the program.
+ * @param[in] offset Offset of the list in the file.
+ * @param[in] index Index of the name in the list.
+ * @return name Returns the name, or NULL when it does not lie
+ *         inside the strings section.
+ */
+static const char* cache_get_name(runtime_T* runtime, const char* map, cache_header_T* header, uint64_t offset, size_t index) {
+    uint64_t name;
+    memcpy(&name, map + offset + index * sizeof(uint64_t), sizeof(name));
+
+    return cache_get_string(runtime, map, header, name);
+}
+
+/**
+ * @brief Checks the code of a function of a mapped program, which the
+ *        virtual machine runs without checking it. The code has no
+ *        jumps, so it runs straight from the entry to its return or
+ *        tail call. Every operand must lie inside the table it refers
+ *        to, calls of builtins must pass the arguments they take, and
+ *        the values on the stack must match the most the function
+ *        makes room for.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] header Pointer to the header of the program.
+ * @param[in] chunk Pointer to the chunk of the program.
+ * @param[in] function Pointer to the function to check.
+ * @return int Returns 1 when the code is valid, 0 otherwise.
+ */
+static int cache_check_function(runtime_T* runtime, cache_header_T* header, chunk_T* chunk, chunk_function_T* function) {
+    size_t ip = function->entry;
+    size_t depth = function->arity;
+    size_t max_depth = depth;
+
+    for (;;) {
+        if (ip >= chunk->code_size) {
+            return 0;
+        }
+
+        opcode_T op = chunk->code[ip++];
+        size_t operands = 0;
+
+        if (op == OP_DEFINE_FN || op == OP_CALL_BUILTIN) {
+            operands = 2;
+        } else if (op == OP_CALL || op == OP_TAIL_CALL) {
+            operands = 3;
+        } else if (op == OP_CONSTANT || op == OP_GET_LOCAL
+                || op == OP_GET_GLOBAL || op == OP_SET_GLOBAL) {
+            operands = 1;
+        }
+
+        if (operands * 4 > chunk->code_size - ip) {
+            return 0;
+        }
+
+        uint32_t a = operands > 0 ? chunk_read_operand(chunk->code + ip) : 0;
+        uint32_t b = operands > 1 ? chunk_read_operand(chunk->code + ip + 4) : 0;
+        uint32_t c = operands > 2 ? chunk_read_operand(chunk->code + ip + 8) : 0;
+        size_t pushed = 0;
+        size_t popped = 0;
+        int valid;
+
+        ip += operands * 4;
+
+        switch (op) {
+            case OP_CONSTANT: valid = a < chunk->constants_size; pushed = 1; break;
+            case OP_NIL: valid = 1; pushed = 1; break;
+            case OP_POP: valid = 1; popped = 1; break;
+            case OP_GET_LOCAL: valid = a < function->arity; pushed = 1; break;
+            case OP_GET_GLOBAL: valid = a < header->globals_size; pushed = 1; break;
+            case OP_SET_GLOBAL: valid = a < header->globals_size; popped = 1; break;
+            case OP_DEFINE_FN: {
+                valid = a < header->function_globals_size && b < chunk->functions_size;
+                break;
+            }
+            case OP_CALL:
+            case OP_TAIL_CALL: {
+                valid = a < header->function_globals_size && c < chunk->call_caches_size;
+                pushed = op == OP_CALL;
+                popped = b;
+                break;
+            }
+            case OP_CALL_BUILTIN: {
+                valid = a < runtime->builtins.size;
+
+                if (valid) {
+                    builtin_T* builtin = &runtime->builtins.entries[a];
+                    valid = builtin->flags & BUILTIN_VARIADIC
+                        ? b >= builtin->arity
+                        : b == builtin->arity;
+                }
+
+                pushed = 1;
+                popped = b;
+                break;
+            }
+            case OP_RETURN: valid = 1; popped = 1; break;
+            case OP_NEGATE: valid = 1; pushed = 1; popped = 1; break;
+            default: {
+                valid = op >= OP_ADD && op <= OP_GREATER_EQUAL;
+                pushed = 1;
+                popped = 2;
+                break;
+            }
+        }
+
+        if (!valid || popped > depth) {
+            return 0;
+        }
+
+        depth = depth - popped + pushed;
+
+        if (depth > max_depth) {
+            max_depth = depth;
+        }
+
+        if (op == OP_RETURN || op == OP_TAIL_CALL) {
+            return max_depth == function->max_stack;
+        }
+    }
+}
+
+/**
+ * @brief Maps a compiled program and binds its globals in the runtime,
+ *        which must not have bound any yet. The program is only used
+ *        when it was compiled from the same source by the same
+ *        version, for the same builtins.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the compiled program.
+ * @param[in] key Key of the source.
+ * @param[in] length Amount of characters in the source.
+ * @return cache Returns the mapped program, or NULL when there is
+ *         none that can be used.
+ */
+cache_T* cache_load(runtime_T* runtime, const char* path, uint64_t key, size_t length) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(cache_header_T)) {
+        close(fd);
+        return NULL;
+    }
+
+    // Private and writable, so that the constants, functions and
+    // call caches are fixed up and used in place, copied on write.
+    size_t size = st.st_size;
+    char* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    cache_header_T* header = (cache_header_T*) map;
+    size_t end = sizeof(cache_header_T);
+
+    int valid = memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == CACHE_VERSION
+        && header->byte_order == CACHE_BYTE_ORDER
+        && header->pointer_size == sizeof(void*)
+        && header->source_hash == key
+        && header->source_length == length
+        && header->functions_size > 0
+        && header->builtins_size == runtime->builtins.size
+        && runtime->globals.size == 0
+        && runtime->functions.size == 0
+        && cache_fits(size, &end, header->code, header->code_size, 1)
+        && cache_fits(size, &end, header->constants, header->constants_size, sizeof(value_T))
+        && cache_fits(size, &end, header->functions, header->functions_size, sizeof(struct CHUNK_FUNCTION_STRUCT))
+        && cache_fits(size, &end, header->call_caches, header->call_caches_size, sizeof(struct CHUNK_CALL_CACHE_STRUCT))
+        && cache_fits(size, &end, header->globals, header->globals_size, sizeof(uint64_t))
+        && cache_fits(size, &end, header->function_globals, header->function_globals_size, sizeof(uint64_t))
+        && cache_fits(size, &end, header->builtins, header->builtins_size, sizeof(uint64_t))
+        && cache_fits(size, &end, header->strings, header->strings_size, 1);
+
+    // Calls to builtins are bound by index, to builtins of the same names.
+    for (size_t i = 0; valid && i < header->builtins_size; i++) {
+        const char* name = cache_get_name(runtime, map, header, header->builtins, i);
+        valid = name != NULL && strcmp(name, runtime->builtins.entries[i].name) == 0;
+    }
+
+    for (size_t i = 0; valid && i < header->globals_size; i++) {
+        valid = cache_get_name(runtime, map, header, header->globals, i) != NULL;
+    }
+
+    for (size_t i = 0; valid && i < header->function_globals_size; i++) {
+        valid = cache_get_name(runtime, map, header, header->function_globals, i) != NULL;
+    }
+
+    // The offsets of the tables are only known to be in the file now.
+    if (!valid) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    chunk_T* chunk = arena_alloc(runtime->arena, sizeof(struct CHUNK_STRUCT));
+    chunk->arena = runtime->arena;
+    chunk->code = (uint8_t*) map + header->code;
+    chunk->code_size = chunk->code_capacity = header->code_size;
+    chunk->constants = (value_T*) (map + header->constants);
+    chunk->constants_size = chunk->constants_capacity = header->constants_size;
+    chunk->functions = (chunk_function_T*) (map + header->functions);
+    chunk->functions_size = chunk->functions_capacity = header->functions_size;
+    chunk->call_caches = (chunk_call_cache_T*) (map + header->call_caches);
+    chunk->call_caches_size = chunk->call_caches_capacity = header->call_caches_size;
+
+    for (size_t i = 0; valid && i < chunk->functions_size; i++) {
+        chunk_function_T* function = &chunk->functions[i];
+        uint64_t name = (uintptr_t) function->name;
+
+        function->chunk = chunk;
+        function->name = name == CACHE_NO_STRING ? NULL : cache_get_string(runtime, map, header, name);
+        valid = (function->name != NULL || name == CACHE_NO_STRING) && function->entry < chunk->code_size;
+    }
+
+    // The top level runs without arguments.
+    valid = valid && chunk->functions[0].arity == 0;
+
+    for (size_t i = 0; valid && i < chunk->functions_size; i++) {
+        valid = cache_check_function(runtime, header, chunk, &chunk->functions[i]);
+    }
+
+    // Call sites start out empty, whatever the file holds.
+    if (valid && chunk->call_caches_size > 0) {
+        memset(chunk->call_caches, 0, chunk->call_caches_size * sizeof(struct CHUNK_CALL_CACHE_STRUCT));
+    }
+
+    for (size_t i = 0; valid && i < chunk->constants_size; i++) {
+        value_T value = chunk->constants[i];
+
+        // Constants are literals, any other value would be a pointer.
+        if (value_is_string(value)) {
+            const char* str = cache_get_string(runtime, map, header, (uintptr_t) value_as_string(value));
+            chunk->constants[i] = value_string(str);
+            valid = str != NULL;
+        } else {
+            valid = value_is_double(value) || value_is_int(value) || value_is_bool(value) || value == VALUE_NIL;
+        }
+    }
+
+    if (!valid) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < header->globals_size; i++) {
+        runtime_add_global(runtime, cache_get_name(runtime, map, header, header->globals, i));
+    }
+
+    for (size_t i = 0; i < header->function_globals_size; i++) {
+        runtime_add_function(runtime, cache_get_name(runtime, map, header, header->function_globals, i));
+    }
+
+    cache_T* cache = calloc(1, sizeof(struct CACHE_STRUCT));
+    cache->map = map;
+    cache->size = size;
+    cache->chunk = chunk;
+
+    return cache;
+}
+
+/**
+ * @brief Unmaps a compiled program. Its chunk must not be used
+ *        anymore.
+ *
+ * @param[in] cache Pointer to the cache struct.
+ * @return void Does not return.
+ */
+void cache_free(cache_T* cache) {
+    munmap(cache->map, cache->size);
+    free(cache);
+}
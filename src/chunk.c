@@ -0,0 +1,156 @@
+#include "include/chunk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Initializes and allocates an empty chunk of bytecode.
+ * 
+ * @param[in] arena Pointer to the arena the chunk grows in.
+ * @return chunk Returns newly allocated chunk.
+ */
+chunk_T* init_chunk(arena_T* arena) {
+    chunk_T* chunk = arena_alloc(arena, sizeof(struct CHUNK_STRUCT));
+    chunk->arena = arena;
+
+    return chunk;
+}
+
+/**
+ * @brief Makes room for more elements in a list of the chunk,
+ *        doubling its capacity when it is used up.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] list List to grow.
+ * @param[in] size Amount of elements the list needs room for.
+ * @param[in,out] capacity Amount of elements the list has room for.
+ * @param[in] element_size Size in bytes of an element.
+ * @return list Returns the list, moved if it had to grow.
+ */
+static void* chunk_grow(chunk_T* chunk, void* list, size_t size, size_t* capacity, size_t element_size) {
+    if (size <= *capacity) {
+        return list;
+    }
+
+    size_t new_capacity = *capacity ? *capacity : 64;
+
+    while (new_capacity < size) {
+        new_capacity *= 2;
+    }
+
+    list = arena_realloc(
+        chunk->arena,
+        list,
+        *capacity * element_size,
+        new_capacity * element_size
+    );
+    *capacity = new_capacity;
+
+    return list;
+}
+
+/**
+ * @brief Appends an opcode to the code.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] op Opcode to append.
+ * @return void Does not return.
+ */
+void chunk_write_op(chunk_T* chunk, opcode_T op) {
+    chunk->code = chunk_grow(chunk, chunk->code, chunk->code_size + 1, &chunk->code_capacity, 1);
+    chunk->code[chunk->code_size++] = op;
+}
+
+/**
+ * @brief Appends a 32-bit operand to the code.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] operand Operand to append.
+ * @return void Does not return.
+ */
+void chunk_write_operand(chunk_T* chunk, size_t operand) {
+    if (operand > UINT32_MAX) {
+        printf("Program too large, operand %zu does not fit\n", operand);
+        exit(1);
+    }
+
+    uint32_t value = operand;
+    chunk->code = chunk_grow(
+        chunk,
+        chunk->code,
+        chunk->code_size + sizeof(value),
+        &chunk->code_capacity,
+        1
+    );
+    memcpy(chunk->code + chunk->code_size, &value, sizeof(value));
+    chunk->code_size += sizeof(value);
+}
+
+/**
+ * @brief Adds a value to the constants.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] value Value of the constant.
+ * @return index Returns the index of the constant.
+ */
+size_t chunk_add_constant(chunk_T* chunk, value_T value) {
+    chunk->constants = chunk_grow(
+        chunk,
+        chunk->constants,
+        chunk->constants_size + 1,
+        &chunk->constants_capacity,
+        sizeof(value_T)
+    );
+    chunk->constants[chunk->constants_size] = value;
+
+    return chunk->constants_size++;
+}
+
+/**
+ * @brief Adds a function whose code has not been compiled yet.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] name Interned string of the function name.
+ * @param[in] arity Amount of arguments of the function.
+ * @return index Returns the index of the function.
+ */
+size_t chunk_add_function(chunk_T* chunk, const char* name, size_t arity) {
+    chunk->functions = chunk_grow(
+        chunk,
+        chunk->functions,
+        chunk->functions_size + 1,
+        &chunk->functions_capacity,
+        sizeof(struct CHUNK_FUNCTION_STRUCT)
+    );
+
+    chunk_function_T* function = &chunk->functions[chunk->functions_size];
+    function->chunk = chunk;
+    function->name = name;
+    function->arity = arity;
+    function->entry = 0;
+    function->max_stack = 0;
+
+    return chunk->functions_size++;
+}
+
+/**
+ * @brief Adds the inline cache of a call site.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @return index Returns the index of the cache.
+ */
+size_t chunk_add_call_cache(chunk_T* chunk) {
+    chunk->call_caches = chunk_grow(
+        chunk,
+        chunk->call_caches,
+        chunk->call_caches_size + 1,
+        &chunk->call_caches_capacity,
+        sizeof(struct CHUNK_CALL_CACHE_STRUCT)
+    );
+
+    chunk_call_cache_T* cache = &chunk->call_caches[chunk->call_caches_size];
+    cache->function = NULL;
+    cache->version = 0;
+
+    return chunk->call_caches_size++;
+}
@@ -0,0 +1,233 @@
+#include "include/compiler.h"
+#include <stdio.h>
+
+/**
+ * @brief Initializes and allocates the compiler.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return compiler Returns newly allocated compiler.
+ */
+compiler_T* init_compiler(runtime_T* runtime) {
+    compiler_T* compiler = arena_alloc(runtime->arena, sizeof(struct COMPILER_STRUCT));
+    compiler->runtime = runtime;
+
+    return compiler;
+}
+
+/**
+ * @brief Appends an opcode and keeps track of how many values
+ *        the function being compiled has on the stack.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] op Opcode to append.
+ * @param[in] pushed Amount of values the instruction pushes.
+ * @param[in] popped Amount of values the instruction pops.
+ * @return void Does not return.
+ */
+static void compiler_emit(compiler_T* compiler, opcode_T op, size_t pushed, size_t popped) {
+    chunk_write_op(compiler->chunk, op);
+
+    compiler->depth = compiler->depth - popped + pushed;
+
+    if (compiler->depth > compiler->max_depth) {
+        compiler->max_depth = compiler->depth;
+    }
+}
+
+/**
+ * @brief Adds a function to the chunk and remembers its definition,
+ *        so that its body is compiled once the current code is done.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] fdef Pointer to the function definition node.
+ * @return index Returns the index of the function in the chunk.
+ */
+static size_t compiler_add_function(compiler_T* compiler, AST_T* fdef) {
+    if (compiler->fdefs_size == compiler->fdefs_capacity) {
+        size_t capacity = compiler->fdefs_capacity ? compiler->fdefs_capacity * 2 : 16;
+        compiler->fdefs = arena_realloc(
+            compiler->runtime->arena,
+            compiler->fdefs,
+            compiler->fdefs_capacity * sizeof(struct AST_STRUCT*),
+            capacity * sizeof(struct AST_STRUCT*)
+        );
+        compiler->fdefs_capacity = capacity;
+    }
+
+    compiler->fdefs[compiler->fdefs_size++] = fdef;
+
+    if (fdef == NULL) {
+        return chunk_add_function(compiler->chunk, NULL, 0);
+    }
+
+    return chunk_add_function(compiler->chunk, fdef->fn_def_name, fdef->fn_def_args_size);
+}
+
+/**
+ * @brief Compiles a resolved program into a new chunk of bytecode.
+ *        Function 0 of the chunk runs the top level of the program.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return chunk Returns newly allocated chunk.
+ */
+chunk_T* compiler_compile(compiler_T* compiler, AST_T* root) {
+    compiler->chunk = init_chunk(compiler->runtime->arena);
+    compiler->fdefs_size = 0;
+
+    compiler_add_function(compiler, NULL);
+
+    // Function definitions found while compiling add to the
+    // functions, so keep going until every body is compiled.
+    for (size_t i = 0; i < compiler->chunk->functions_size; i++) {
+        chunk_function_T* function = &compiler->chunk->functions[i];
+        AST_T* body = i == 0 ? root : compiler->fdefs[i]->fn_def_body;
+
+        function->entry = compiler->chunk->code_size;
+        compiler->depth = function->arity;
+        compiler->max_depth = function->arity;
+
+        if (i == 0) {
+            compiler_compile_expr(compiler, body);
+            compiler_emit(compiler, OP_RETURN, 0, 1);
+        } else {
+            compiler_compile_body(compiler, body);
+        }
+
+        // The chunk may have moved its functions while compiling.
+        compiler->chunk->functions[i].max_stack = compiler->max_depth;
+    }
+
+    return compiler->chunk;
+}
+
+/**
+ * @brief Compiles a function body. A call in tail position replaces
+ *        the call of the body, otherwise the body returns nil.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] body Pointer to the compound of the function body.
+ * @return void Does not return.
+ */
+void compiler_compile_body(compiler_T* compiler, AST_T* body) {
+    size_t size;
+    AST_T* tail = runtime_tail_call(body, &size);
+
+    for (size_t i = 0; i < size; i++) {
+        compiler_compile_statement(compiler, body->compound_value[i]);
+    }
+
+    if (tail == NULL) {
+        compiler_emit(compiler, OP_NIL, 1, 0);
+        compiler_emit(compiler, OP_RETURN, 0, 1);
+        return;
+    }
+
+    for (size_t i = 0; i < tail->fn_call_args_size; i++) {
+        compiler_compile_expr(compiler, tail->fn_call_args[i]);
+    }
+
+    compiler_emit(compiler, OP_TAIL_CALL, 0, tail->fn_call_args_size);
+    chunk_write_operand(compiler->chunk, tail->fn_call_index);
+    chunk_write_operand(compiler->chunk, tail->fn_call_args_size);
+    chunk_write_operand(compiler->chunk, chunk_add_call_cache(compiler->chunk));
+}
+
+/**
+ * @brief Compiles a statement, which leaves the stack as it was.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] node Pointer to the statement node.
+ * @return void Does not return.
+ */
+void compiler_compile_statement(compiler_T* compiler, AST_T* node) {
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            compiler_compile_expr(compiler, node->var_def_value);
+            compiler_emit(compiler, OP_SET_GLOBAL, 0, 1);
+            chunk_write_operand(compiler->chunk, node->var_def_index);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            size_t function = compiler_add_function(compiler, node);
+            compiler_emit(compiler, OP_DEFINE_FN, 0, 0);
+            chunk_write_operand(compiler->chunk, node->fn_def_index);
+            chunk_write_operand(compiler->chunk, function);
+            break;
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                compiler_compile_statement(compiler, node->compound_value[i]);
+            }
+            break;
+        }
+        case AST_NOOP: {
+            break;
+        }
+        default: {
+            compiler_compile_expr(compiler, node);
+            compiler_emit(compiler, OP_POP, 0, 1);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Compiles an expression, which pushes exactly one value.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] node Pointer to the expression node.
+ * @return void Does not return.
+ */
+void compiler_compile_expr(compiler_T* compiler, AST_T* node) {
+    switch (node->type) {
+        case AST_STRING:
+        case AST_INTEGER:
+        case AST_FLOAT:
+        case AST_BOOLEAN: {
+            compiler_emit(compiler, OP_CONSTANT, 1, 0);
+            chunk_write_operand(compiler->chunk, chunk_add_constant(compiler->chunk, ast_literal_value(node)));
+            break;
+        }
+        case AST_BINARY: {
+            compiler_compile_expr(compiler, node->binary_left);
+            compiler_compile_expr(compiler, node->binary_right);
+            compiler_emit(compiler, OP_ADD + node->binary_op, 1, 2);
+            break;
+        }
+        case AST_NEGATE: {
+            compiler_compile_expr(compiler, node->negate_value);
+            compiler_emit(compiler, OP_NEGATE, 1, 1);
+            break;
+        }
+        case AST_VARIABLE: {
+            compiler_emit(compiler, node->var_local ? OP_GET_LOCAL : OP_GET_GLOBAL, 1, 0);
+            chunk_write_operand(compiler->chunk, node->var_index);
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                compiler_compile_expr(compiler, node->fn_call_args[i]);
+            }
+
+            if (node->fn_call_builtin) {
+                compiler_emit(compiler, OP_CALL_BUILTIN, 1, node->fn_call_args_size);
+                chunk_write_operand(compiler->chunk, node->fn_call_index);
+                chunk_write_operand(compiler->chunk, node->fn_call_args_size);
+                break;
+            }
+
+            compiler_emit(compiler, OP_CALL, 1, node->fn_call_args_size);
+            chunk_write_operand(compiler->chunk, node->fn_call_index);
+            chunk_write_operand(compiler->chunk, node->fn_call_args_size);
+            chunk_write_operand(compiler->chunk, chunk_add_call_cache(compiler->chunk));
+            break;
+        }
+        default: {
+            // Definitions, compounds and noops have no value of their own.
+            compiler_compile_statement(compiler, node);
+            compiler_emit(compiler, OP_NIL, 1, 0);
+            break;
+        }
+    }
+}
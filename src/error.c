@@ -0,0 +1,58 @@
+#include "include/error.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Reports an error. Without a jump the message is printed on
+ *        its own line, otherwise the first message is kept.
+ *
+ * @param[in] error Pointer to the error struct, or NULL to print.
+ * @param[in] format Format string of the message, without newline.
+ * @return void Does not return.
+ */
+void error_report(error_T* error, const char* format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    error_vreport(error, format, args);
+    va_end(args);
+}
+
+/**
+ * @brief Reports an error with the arguments of the format in a list.
+ *
+ * @param[in] error Pointer to the error struct, or NULL to print.
+ * @param[in] format Format string of the message, without newline.
+ * @param[in] args Arguments of the format.
+ * @return void Does not return.
+ */
+void error_vreport(error_T* error, const char* format, va_list args) {
+    if (error == NULL || error->jump == NULL) {
+        vprintf(format, args);
+        printf("\n");
+        fflush(stdout);
+        return;
+    }
+
+    if (error->count == 0) {
+        vsnprintf(error->message, sizeof(error->message), format, args);
+    }
+
+    error->count += 1;
+}
+
+/**
+ * @brief Gives up after the reported errors. Jumps back to the host
+ *        when there is a jump, otherwise exits.
+ *
+ * @param[in] error Pointer to the error struct, or NULL to exit.
+ * @param[in] status Exit status when there is no jump.
+ * @return void Does not return.
+ */
+void error_raise(error_T* error, int status) {
+    if (error == NULL || error->jump == NULL) {
+        exit(status);
+    }
+
+    longjmp(*error->jump, 1);
+}
@@ -0,0 +1,186 @@
+#include "include/folder.h"
+
+/**
+ * @brief Initializes and allocates the folder.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return folder Returns newly allocated folder.
+ */
+folder_T* init_folder(runtime_T* runtime) {
+    folder_T* folder = arena_alloc(runtime->arena, sizeof(struct FOLDER_STRUCT));
+    folder->runtime = runtime;
+    folder->first_global = 0;
+    folder->persistent = 0;
+    folder->functions = 0;
+
+    return folder;
+}
+
+/**
+ * @brief Folds a resolved program. Operations on literals are replaced
+ *        by the literal of their result, unless they would fail at
+ *        runtime. A variable that is defined once, by a top level
+ *        statement with a literal value, is replaced by that literal
+ *        wherever it is used after the definition, unless an earlier
+ *        program bound it, and not inside of functions if the folder
+ *        is persistent.
+ * 
+ * @param[in] folder Pointer to the folder struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return void Does not return.
+ */
+void folder_fold(folder_T* folder, AST_T* root) {
+    size_t globals_size = folder->runtime->globals.size;
+    folder->definitions = arena_alloc(folder->runtime->arena, globals_size * sizeof(size_t));
+    folder->constants = arena_alloc(folder->runtime->arena, globals_size * sizeof(struct AST_STRUCT*));
+
+    folder_count(folder, root);
+
+    // Top level statements run once and in order, so everything after
+    // the only definition of a variable sees the value it defines.
+    for (size_t i = 0; i < root->compound_size; i++) {
+        AST_T* statement = folder_fold_node(folder, root->compound_value[i]);
+        root->compound_value[i] = statement;
+
+        if (statement->type == AST_VARIABLE_DEFINITION
+                && statement->var_def_index >= folder->first_global
+                && folder->definitions[statement->var_def_index] == 1
+                && ast_is_literal(statement->var_def_value)) {
+            folder->constants[statement->var_def_index] = statement->var_def_value;
+        }
+    }
+}
+
+/**
+ * @brief Counts the definitions of every variable global below a node.
+ * 
+ * @param[in] folder Pointer to the folder struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void folder_count(folder_T* folder, AST_T* node) {
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            folder->definitions[node->var_def_index] += 1;
+            folder_count(folder, node->var_def_value);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            folder_count(folder, node->fn_def_body);
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                folder_count(folder, node->fn_call_args[i]);
+            }
+            break;
+        }
+        case AST_BINARY: {
+            folder_count(folder, node->binary_left);
+            folder_count(folder, node->binary_right);
+            break;
+        }
+        case AST_NEGATE: {
+            folder_count(folder, node->negate_value);
+            break;
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                folder_count(folder, node->compound_value[i]);
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+/**
+ * @brief Folds the node and everything below it.
+ * 
+ * @param[in] folder Pointer to the folder struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return AST_T Returns the folded node, which replaces the visited one.
+ */
+AST_T* folder_fold_node(folder_T* folder, AST_T* node) {
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            node->var_def_value = folder_fold_node(folder, node->var_def_value);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            folder->functions += 1;
+            node->fn_def_body = folder_fold_node(folder, node->fn_def_body);
+            folder->functions -= 1;
+            break;
+        }
+        case AST_VARIABLE: {
+            // A later program may define the variable again before it
+            // calls a function that outlives this one.
+            if (folder->persistent && folder->functions > 0) {
+                break;
+            }
+
+            if (!node->var_local && folder->constants[node->var_index] != NULL) {
+                return folder->constants[node->var_index];
+            }
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                node->fn_call_args[i] = folder_fold_node(folder, node->fn_call_args[i]);
+            }
+            break;
+        }
+        case AST_BINARY: {
+            node->binary_left = folder_fold_node(folder, node->binary_left);
+            node->binary_right = folder_fold_node(folder, node->binary_right);
+
+            if (!ast_is_literal(node->binary_left) || !ast_is_literal(node->binary_right)) {
+                break;
+            }
+
+            // Operations that fail are left for the runtime to report.
+            value_T result;
+            value_status_T status = value_binary(
+                node->binary_op,
+                ast_literal_value(node->binary_left),
+                ast_literal_value(node->binary_right),
+                &result
+            );
+
+            if (status == VALUE_OK) {
+                AST_T* literal = init_ast_literal(folder->runtime->arena, result);
+                literal->scope = node->scope;
+
+                return literal;
+            }
+            break;
+        }
+        case AST_NEGATE: {
+            node->negate_value = folder_fold_node(folder, node->negate_value);
+
+            if (!ast_is_literal(node->negate_value)) {
+                break;
+            }
+
+            value_T result;
+
+            if (value_negate(ast_literal_value(node->negate_value), &result) == VALUE_OK) {
+                AST_T* literal = init_ast_literal(folder->runtime->arena, result);
+                literal->scope = node->scope;
+
+                return literal;
+            }
+            break;
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                node->compound_value[i] = folder_fold_node(folder, node->compound_value[i]);
+            }
+            break;
+        }
+        default: break;
+    }
+
+    return node;
+}
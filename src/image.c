@@ -0,0 +1,859 @@
+#include "include/image.h"
+#include "include/intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define IMAGE_OFFSETS_CAPACITY 64
+
+/* Bytes of the file or of its strings section while it is written. */
+typedef struct IMAGE_BUFFER_STRUCT
+{
+    char* data;
+    size_t size;
+    size_t capacity;
+} image_buffer_T;
+
+/* Open addressing map from nodes or strings to their offset in the
+   image, the capacity is a power of two. */
+typedef struct IMAGE_OFFSETS_STRUCT
+{
+    const void** keys;
+    uint64_t* offsets;
+    size_t size;
+    size_t capacity;
+} image_offsets_T;
+
+typedef struct IMAGE_WRITER_STRUCT
+{
+    image_buffer_T file;
+    image_buffer_T strings;
+    image_offsets_T nodes_offsets;
+    image_offsets_T strings_offsets;
+} image_writer_T;
+
+/**
+ * @brief Makes room in a buffer for it to hold a size.
+ *
+ * @param[in] buffer Pointer to the buffer.
+ * @param[in] size Amount of bytes the buffer has to hold.
+ * @return void Does not return.
+ */
+static void image_reserve(image_buffer_T* buffer, size_t size) {
+    if (buffer->data != NULL && size <= buffer->capacity) {
+        return;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    buffer->data = realloc(buffer->data, capacity);
+    buffer->capacity = capacity;
+}
+
+/**
+ * @brief Appends bytes to a buffer, behind padding that aligns them
+ *        to 8 bytes.
+ *
+ * @param[in] buffer Pointer to the buffer.
+ * @param[in] data Bytes to append, or NULL for zeroes.
+ * @param[in] size Amount of bytes.
+ * @return offset Returns the offset of the bytes in the buffer.
+ */
+static uint64_t image_append(image_buffer_T* buffer, const void* data, size_t size) {
+    size_t offset = (buffer->size + 7) & ~(size_t) 7;
+    image_reserve(buffer, offset + size);
+
+    memset(buffer->data + buffer->size, 0, offset - buffer->size);
+
+    if (data != NULL && size > 0) {
+        memcpy(buffer->data + offset, data, size);
+    } else {
+        memset(buffer->data + offset, 0, size);
+    }
+
+    buffer->size = offset + size;
+
+    return offset;
+}
+
+/**
+ * @brief Overwrites 8 bytes of a buffer.
+ *
+ * @param[in] buffer Pointer to the buffer.
+ * @param[in] offset Offset of the bytes.
+ * @param[in] value Value to write.
+ * @return void Does not return.
+ */
+static void image_set(image_buffer_T* buffer, uint64_t offset, uint64_t value) {
+    memcpy(buffer->data + offset, &value, sizeof(value));
+}
+
+/**
+ * @brief Finds the slot of a pointer in a map of offsets.
+ *
+ * @param[in] keys Keys of the map.
+ * @param[in] capacity Capacity of the map, a power of two.
+ * @param[in] key Pointer to find.
+ * @return index Returns the index of the slot holding the pointer,
+ *         or of the empty slot where it belongs.
+ */
+static size_t image_offsets_find(const void** keys, size_t capacity, const void* key) {
+    uint64_t hash = (uintptr_t) key * 11400714819323198485ULL;
+    size_t i = (hash ^ (hash >> 32)) & (capacity - 1);
+
+    while (keys[i] != NULL && keys[i] != key) {
+        i = (i + 1) & (capacity - 1);
+    }
+
+    return i;
+}
+
+/**
+ * @brief Gives the slot of a pointer in a map of offsets, growing the
+ *        map when it is half full.
+ *
+ * @param[in] map Pointer to the map.
+ * @param[in] key Pointer to find.
+ * @return index Returns the index of the slot holding the pointer,
+ *         or of the empty slot where it belongs.
+ */
+static size_t image_offsets_slot(image_offsets_T* map, const void* key) {
+    if ((map->size + 1) * 2 > map->capacity) {
+        const void** keys = map->keys;
+        uint64_t* offsets = map->offsets;
+        size_t capacity = map->capacity;
+
+        map->capacity = capacity ? capacity * 2 : IMAGE_OFFSETS_CAPACITY;
+        map->keys = calloc(map->capacity, sizeof(void*));
+        map->offsets = malloc(map->capacity * sizeof(uint64_t));
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (keys[i] != NULL) {
+                size_t j = image_offsets_find(map->keys, map->capacity, keys[i]);
+                map->keys[j] = keys[i];
+                map->offsets[j] = offsets[i];
+            }
+        }
+
+        free(keys);
+        free(offsets);
+    }
+
+    return image_offsets_find(map->keys, map->capacity, key);
+}
+
+/**
+ * @brief Gives the offset of a string in the strings section, adding
+ *        it on its first use.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] str Interned string.
+ * @return offset Returns the offset of the string.
+ */
+static uint64_t image_write_string(image_writer_T* writer, const char* str) {
+    image_offsets_T* map = &writer->strings_offsets;
+    size_t i = image_offsets_slot(map, str);
+
+    if (map->keys[i] == NULL) {
+        map->keys[i] = str;
+        map->offsets[i] = writer->strings.size;
+        map->size += 1;
+
+        // Strings are packed, only sections are aligned.
+        size_t length = strlen(str) + 1;
+        image_reserve(&writer->strings, writer->strings.size + length);
+        memcpy(writer->strings.data + writer->strings.size, str, length);
+        writer->strings.size += length;
+    }
+
+    return map->offsets[i];
+}
+
+/**
+ * @brief Gives the list of child nodes of a node.
+ *
+ * @param[in] node Pointer to the node.
+ * @param[out] size Amount of child nodes in the list.
+ * @return list Returns the list, or NULL when the node has none.
+ */
+static AST_T** image_list(AST_T* node, size_t* size) {
+    switch (node->type) {
+        case AST_FUNCTION_DEFINITION: {
+            *size = node->fn_def_args_size;
+            return node->fn_def_args;
+        }
+        case AST_FUNCTION_CALL: {
+            *size = node->fn_call_args_size;
+            return node->fn_call_args;
+        }
+        case AST_COMPOUND: {
+            *size = node->compound_size;
+            return node->compound_value;
+        }
+        default: {
+            *size = 0;
+            return NULL;
+        }
+    }
+}
+
+/**
+ * @brief Writes a node and every node below it, each one once.
+ *
+ * @param[in] writer Pointer to the writer.
+ * @param[in] node Pointer to the node.
+ * @return offset Returns the offset of the node in the file.
+ */
+static uint64_t image_write_node(image_writer_T* writer, AST_T* node) {
+    image_offsets_T* map = &writer->nodes_offsets;
+    size_t slot = image_offsets_slot(map, node);
+
+    if (map->keys[slot] != NULL) {
+        return map->offsets[slot];
+    }
+
+    size_t list_size;
+    AST_T** list = image_list(node, &list_size);
+    size_t node_size = ast_node_size(node->type);
+
+    uint64_t offset = image_append(&writer->file, node, node_size);
+    image_append(&writer->file, NULL, list_size * sizeof(uint64_t));
+
+    map->keys[slot] = node;
+    map->offsets[slot] = offset;
+    map->size += 1;
+
+    image_set(&writer->file, offset + offsetof(struct AST_STRUCT, scope), 0);
+
+    // The buffer may move while the children are written.
+    for (size_t i = 0; i < list_size; i++) {
+        uint64_t child = image_write_node(writer, list[i]);
+        image_set(&writer->file, offset + node_size + i * sizeof(uint64_t), child);
+    }
+
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, var_def_var_name), image_write_string(writer, node->var_def_var_name));
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, var_def_value), image_write_node(writer, node->var_def_value));
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_def_name), image_write_string(writer, node->fn_def_name));
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_def_args), offset + node_size);
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_def_body), image_write_node(writer, node->fn_def_body));
+            break;
+        }
+        case AST_VARIABLE: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, var_name), image_write_string(writer, node->var_name));
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_call_name), image_write_string(writer, node->fn_call_name));
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_call_args), offset + node_size);
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_call_fdef), 0);
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, fn_call_version), 0);
+            break;
+        }
+        case AST_STRING: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, string_value), image_write_string(writer, node->string_value));
+            break;
+        }
+        case AST_BINARY: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, binary_left), image_write_node(writer, node->binary_left));
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, binary_right), image_write_node(writer, node->binary_right));
+            break;
+        }
+        case AST_NEGATE: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, negate_value), image_write_node(writer, node->negate_value));
+            break;
+        }
+        case AST_COMPOUND: {
+            image_set(&writer->file, offset + offsetof(struct AST_STRUCT, compound_value), offset + node_size);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Writes the globals and functions of the runtime to an image,
+ *        to start later runs from. The program exits when the image
+ *        cannot be written.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the image.
+ * @return void Does not return.
+ */
+void image_dump(runtime_T* runtime, const char* path) {
+    image_writer_T writer = { 0 };
+    image_header_T header = { 0 };
+
+    memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+    header.version = IMAGE_VERSION;
+    header.byte_order = IMAGE_BYTE_ORDER;
+    header.pointer_size = sizeof(void*);
+
+    image_append(&writer.file, &header, sizeof(header));
+
+    // Nodes come first, so that their offsets are final as they are
+    // written, and only the definitions of functions are reachable.
+    header.nodes = (writer.file.size + 7) & ~(size_t) 7;
+    uint64_t* fdefs = calloc(runtime->functions.size + 1, sizeof(uint64_t));
+
+    for (size_t i = 0; i < runtime->functions.size; i++) {
+        value_T function = runtime->functions.values[i];
+
+        if (function != VALUE_UNDEFINED) {
+            fdefs[i] = image_write_node(&writer, (AST_T*) value_as_function(function));
+        }
+    }
+
+    header.nodes_size = writer.file.size - header.nodes;
+
+    header.globals = image_append(&writer.file, NULL, runtime->globals.size * sizeof(struct IMAGE_ENTRY_STRUCT));
+    header.globals_size = runtime->globals.size;
+
+    for (size_t i = 0; i < runtime->globals.size; i++) {
+        value_T value = runtime->globals.values[i];
+
+        if (value_is_string(value)) {
+            value = value_string((const char*) (uintptr_t) image_write_string(&writer, value_as_string(value)));
+        }
+
+        image_entry_T entry = { image_write_string(&writer, runtime->globals.names[i]), value };
+        memcpy(writer.file.data + header.globals + i * sizeof(entry), &entry, sizeof(entry));
+    }
+
+    header.functions = image_append(&writer.file, NULL, runtime->functions.size * sizeof(struct IMAGE_ENTRY_STRUCT));
+    header.functions_size = runtime->functions.size;
+
+    for (size_t i = 0; i < runtime->functions.size; i++) {
+        image_entry_T entry = { image_write_string(&writer, runtime->functions.names[i]), fdefs[i] };
+        memcpy(writer.file.data + header.functions + i * sizeof(entry), &entry, sizeof(entry));
+    }
+
+    header.builtins = image_append(&writer.file, NULL, runtime->builtins.size * sizeof(uint64_t));
+    header.builtins_size = runtime->builtins.size;
+
+    for (size_t i = 0; i < runtime->builtins.size; i++) {
+        image_set(&writer.file, header.builtins + i * sizeof(uint64_t), image_write_string(&writer, runtime->builtins.entries[i].name));
+    }
+
+    header.strings = image_append(&writer.file, writer.strings.data, writer.strings.size);
+    header.strings_size = writer.strings.size;
+
+    memcpy(writer.file.data, &header, sizeof(header));
+
+    // Written aside and renamed, so that no run maps a partial image.
+    size_t tmp_length = strlen(path) + 32;
+    char* tmp = malloc(tmp_length);
+    snprintf(tmp, tmp_length, "%s.%ld.tmp", path, (long) getpid());
+
+    FILE* file = fopen(tmp, "wb");
+    int written = 0;
+
+    if (file != NULL) {
+        written = fwrite(writer.file.data, 1, writer.file.size, file) == writer.file.size;
+        written = fclose(file) == 0 && written && rename(tmp, path) == 0;
+    }
+
+    if (!written) {
+        unlink(tmp);
+        free(tmp);
+        runtime_error(runtime, "Could not write image `%s`", path);
+    }
+
+    free(tmp);
+    free(fdefs);
+    free(writer.file.data);
+    free(writer.strings.data);
+    free(writer.nodes_offsets.keys);
+    free(writer.nodes_offsets.offsets);
+    free(writer.strings_offsets.keys);
+    free(writer.strings_offsets.offsets);
+}
+
+/**
+ * @brief Reports an image that cannot be used and exits.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the image.
+ * @return void Does not return.
+ */
+static void image_error(runtime_T* runtime, const char* path) __attribute__((noreturn));
+
+static void image_error(runtime_T* runtime, const char* path) {
+    runtime_error(runtime, "Could not load image `%s`", path);
+}
+
+/**
+ * @brief Checks that a section lies inside the file.
+ *
+ * @param[in] size Size in bytes of the file.
+ * @param[in] offset Offset of the section.
+ * @param[in] count Amount of elements of the section.
+ * @param[in] element_size Size in bytes of an element.
+ * @return int Returns 1 when the section fits, 0 otherwise.
+ */
+static int image_fits(size_t size, uint64_t offset, uint64_t count, size_t element_size) {
+    return offset % 8 == 0
+        && offset <= size
+        && count <= (size - offset) / element_size;
+}
+
+/* Mapped image while it is checked and its nodes are fixed up. */
+typedef struct IMAGE_READER_STRUCT
+{
+    runtime_T* runtime;
+    const char* path;
+    char* map;
+    image_header_T* header;
+
+    /* One flag for every 8 bytes of the nodes section, set where
+       a node starts. */
+    uint8_t* starts;
+} image_reader_T;
+
+/**
+ * @brief Gives a string of the strings section, interned so that it
+ *        is the same string as the one the lexer would give.
+ *
+ * @param[in] reader Pointer to the reader.
+ * @param[in] offset Offset of the string in the strings section.
+ * @return str Returns the interned string, the program exits when
+ *         it does not lie inside the strings section.
+ */
+static const char* image_read_string(image_reader_T* reader, uint64_t offset) {
+    image_header_T* header = reader->header;
+
+    if (offset >= header->strings_size) {
+        image_error(reader->runtime, reader->path);
+    }
+
+    const char* str = reader->map + header->strings + offset;
+    const char* end = memchr(str, '\0', header->strings_size - offset);
+
+    if (end == NULL) {
+        image_error(reader->runtime, reader->path);
+    }
+
+    return interner_intern(reader->runtime->interner, str, end - str);
+}
+
+/**
+ * @brief Gives a node of the nodes section.
+ *
+ * @param[in] reader Pointer to the reader.
+ * @param[in] offset Offset of the node in the file.
+ * @return node Returns the node, the program exits when no node
+ *         starts at the offset.
+ */
+static AST_T* image_read_node(image_reader_T* reader, uint64_t offset) {
+    image_header_T* header = reader->header;
+
+    if (offset < header->nodes
+            || offset - header->nodes >= header->nodes_size
+            || offset % 8 != 0
+            || !reader->starts[(offset - header->nodes) / 8]) {
+        image_error(reader->runtime, reader->path);
+    }
+
+    return (AST_T*) (reader->map + offset);
+}
+
+/**
+ * @brief Fixes up a node in place, its pointers to nodes and strings
+ *        become pointers into the mapping and the interner, and checks
+ *        the globals and builtins it is bound to.
+ *
+ * @param[in] reader Pointer to the reader.
+ * @param[in] node Pointer to the node.
+ * @return void Does not return.
+ */
+static void image_read_fields(image_reader_T* reader, AST_T* node) {
+    image_header_T* header = reader->header;
+    size_t list_size;
+    AST_T** list;
+    int valid = 1;
+
+    node->scope = NULL;
+
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            node->var_def_var_name = image_read_string(reader, (uintptr_t) node->var_def_var_name);
+            node->var_def_value = image_read_node(reader, (uintptr_t) node->var_def_value);
+            valid = node->var_def_index < header->globals_size;
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            node->fn_def_name = image_read_string(reader, (uintptr_t) node->fn_def_name);
+            node->fn_def_body = image_read_node(reader, (uintptr_t) node->fn_def_body);
+            valid = node->fn_def_index < header->functions_size;
+            break;
+        }
+        case AST_VARIABLE: {
+            node->var_name = image_read_string(reader, (uintptr_t) node->var_name);
+            valid = node->var_local || node->var_index < header->globals_size;
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            node->fn_call_name = image_read_string(reader, (uintptr_t) node->fn_call_name);
+            node->fn_call_fdef = NULL;
+            node->fn_call_version = 0;
+            valid = node->fn_call_index < (node->fn_call_builtin ? header->builtins_size : header->functions_size);
+            break;
+        }
+        case AST_STRING: {
+            node->string_value = image_read_string(reader, (uintptr_t) node->string_value);
+            break;
+        }
+        case AST_BINARY: {
+            node->binary_left = image_read_node(reader, (uintptr_t) node->binary_left);
+            node->binary_right = image_read_node(reader, (uintptr_t) node->binary_right);
+            break;
+        }
+        case AST_NEGATE: {
+            node->negate_value = image_read_node(reader, (uintptr_t) node->negate_value);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    if (!valid) {
+        image_error(reader->runtime, reader->path);
+    }
+
+    // The list lies right behind the node, wherever the file says.
+    list = (AST_T**) ((char*) node + ast_node_size(node->type));
+    image_list(node, &list_size);
+
+    switch (node->type) {
+        case AST_FUNCTION_DEFINITION: node->fn_def_args = list; break;
+        case AST_FUNCTION_CALL: node->fn_call_args = list; break;
+        case AST_COMPOUND: node->compound_value = list; break;
+        default: break;
+    }
+
+    for (size_t i = 0; i < list_size; i++) {
+        list[i] = image_read_node(reader, (uintptr_t) list[i]);
+    }
+}
+
+/**
+ * @brief Checks that the nodes below a node have no cycle, folded
+ *        literals may be shared, and that its variables only read the
+ *        argument slots of their function.
+ *
+ * @param[in] reader Pointer to the reader.
+ * @param[in] node Pointer to the fixed up node.
+ * @param[in] fdef Pointer to the definition of the function the node
+ *            is in, or NULL at the top level.
+ * @return void Does not return.
+ */
+static void image_check_node(image_reader_T* reader, AST_T* node, AST_T* fdef) {
+    uint8_t* state = &reader->starts[((char*) node - reader->map - reader->header->nodes) / 8];
+
+    // 1 for a node that was not visited yet, 2 while below it and
+    // 3 once everything below it was checked.
+    if (*state == 3) {
+        return;
+    }
+
+    if (*state != 1) {
+        image_error(reader->runtime, reader->path);
+    }
+
+    *state = 2;
+
+    size_t list_size;
+    AST_T** list = image_list(node, &list_size);
+
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            image_check_node(reader, node->var_def_value, fdef);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            for (size_t i = 0; i < list_size; i++) {
+                if (list[i]->type != AST_VARIABLE) {
+                    image_error(reader->runtime, reader->path);
+                }
+            }
+
+            // Calls look for a tail call among the statements of the body.
+            if (node->fn_def_body->type != AST_COMPOUND) {
+                image_error(reader->runtime, reader->path);
+            }
+
+            image_check_node(reader, node->fn_def_body, node);
+            break;
+        }
+        case AST_VARIABLE: {
+            if (node->var_local && (fdef == NULL || node->var_index >= fdef->fn_def_args_size)) {
+                image_error(reader->runtime, reader->path);
+            }
+
+            break;
+        }
+        case AST_BINARY: {
+            if ((unsigned) node->binary_op > VALUE_OP_GREATER_EQUAL) {
+                image_error(reader->runtime, reader->path);
+            }
+
+            image_check_node(reader, node->binary_left, fdef);
+            image_check_node(reader, node->binary_right, fdef);
+            break;
+        }
+        case AST_NEGATE: {
+            image_check_node(reader, node->negate_value, fdef);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    if (node->type == AST_FUNCTION_CALL || node->type == AST_COMPOUND) {
+        for (size_t i = 0; i < list_size; i++) {
+            image_check_node(reader, list[i], fdef);
+        }
+    }
+
+    *state = 3;
+}
+
+/**
+ * @brief Maps an image and restores its globals and functions into
+ *        the runtime, which must not have bound any yet. The program
+ *        exits when the image cannot be used.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the image.
+ * @return image Returns the mapped image.
+ */
+image_T* image_load(runtime_T* runtime, const char* path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(image_header_T)) {
+        image_error(runtime, path);
+    }
+
+    // Private and writable, so that the nodes are fixed up and run in
+    // place, copied on write.
+    size_t size = st.st_size;
+    char* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        image_error(runtime, path);
+    }
+
+    image_header_T* header = (image_header_T*) map;
+
+    int valid = memcmp(header->magic, IMAGE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == IMAGE_VERSION
+        && header->byte_order == IMAGE_BYTE_ORDER
+        && header->pointer_size == sizeof(void*)
+        && header->builtins_size == runtime->builtins.size
+        && runtime->globals.size == 0
+        && runtime->functions.size == 0
+        && image_fits(size, header->nodes, header->nodes_size, 1)
+        && image_fits(size, header->globals, header->globals_size, sizeof(struct IMAGE_ENTRY_STRUCT))
+        && image_fits(size, header->functions, header->functions_size, sizeof(struct IMAGE_ENTRY_STRUCT))
+        && image_fits(size, header->builtins, header->builtins_size, sizeof(uint64_t))
+        && image_fits(size, header->strings, header->strings_size, 1);
+
+    if (!valid) {
+        image_error(runtime, path);
+    }
+
+    image_reader_T reader = { runtime, path, map, header, NULL };
+
+    // Calls to builtins are bound by index, to builtins of the same names.
+    for (size_t i = 0; i < header->builtins_size; i++) {
+        uint64_t name;
+        memcpy(&name, map + header->builtins + i * sizeof(uint64_t), sizeof(name));
+
+        if (image_read_string(&reader, name) != runtime->builtins.entries[i].name) {
+            image_error(runtime, path);
+        }
+    }
+
+    // Nodes are packed one behind the other, find where each starts
+    // before any pointer to one is trusted.
+    reader.starts = calloc(header->nodes_size / 8 + 1, 1);
+    uint64_t offset = 0;
+
+    while (offset < header->nodes_size) {
+        AST_T* node = (AST_T*) (map + header->nodes + offset);
+        size_t rest = header->nodes_size - offset;
+        size_t list_size;
+
+        if (rest < ast_node_size(AST_NOOP)
+                || (unsigned) node->type >= AST_TYPES
+                || rest < ast_node_size(node->type)) {
+            image_error(runtime, path);
+        }
+
+        rest -= ast_node_size(node->type);
+        image_list(node, &list_size);
+
+        if (list_size > rest / sizeof(uint64_t)) {
+            image_error(runtime, path);
+        }
+
+        reader.starts[offset / 8] = 1;
+        offset += ast_node_size(node->type) + list_size * sizeof(uint64_t);
+    }
+
+    for (offset = 0; offset < header->nodes_size; ) {
+        AST_T* node = (AST_T*) (map + header->nodes + offset);
+        size_t list_size;
+
+        image_list(node, &list_size);
+        offset += ast_node_size(node->type) + list_size * sizeof(uint64_t);
+        image_read_fields(&reader, node);
+    }
+
+    image_T* image = calloc(1, sizeof(struct IMAGE_STRUCT));
+    image->runtime = runtime;
+    image->map = map;
+    image->size = size;
+    image->globals_size = header->globals_size;
+    image->fdefs_size = header->functions_size;
+    image->fdefs = calloc(header->functions_size + 1, sizeof(struct AST_STRUCT*));
+
+    for (size_t i = 0; i < header->globals_size; i++) {
+        image_entry_T entry;
+        memcpy(&entry, map + header->globals + i * sizeof(entry), sizeof(entry));
+
+        size_t global = runtime_add_global(runtime, image_read_string(&reader, entry.name));
+
+        if (value_is_string(entry.value)) {
+            entry.value = value_string(image_read_string(&reader, (uintptr_t) value_as_string(entry.value)));
+        } else if (value_is_function(entry.value)) {
+            image_error(runtime, path);
+        }
+
+        runtime->globals.values[global] = entry.value;
+    }
+
+    for (size_t i = 0; i < header->functions_size; i++) {
+        image_entry_T entry;
+        memcpy(&entry, map + header->functions + i * sizeof(entry), sizeof(entry));
+
+        size_t function = runtime_add_function(runtime, image_read_string(&reader, entry.name));
+
+        if (entry.value != 0) {
+            AST_T* fdef = image_read_node(&reader, entry.value);
+
+            if (fdef->type != AST_FUNCTION_DEFINITION || fdef->fn_def_index != function) {
+                image_error(runtime, path);
+            }
+
+            image_check_node(&reader, fdef, NULL);
+
+            image->fdefs[function] = fdef;
+            runtime->functions.values[function] = value_function(fdef);
+        }
+    }
+
+    free(reader.starts);
+
+    return image;
+}
+
+/**
+ * @brief Declares the globals and functions of the image in the scope
+ *        of a program, so that the resolver binds the program to them.
+ *
+ * @param[in] image Pointer to the image struct.
+ * @param[in] scope Pointer to the scope of the program.
+ * @return void Does not return.
+ */
+void image_declare(image_T* image, scope_T* scope) {
+    runtime_T* runtime = image->runtime;
+
+    // The resolver only needs the name and the global of a definition.
+    for (size_t i = 0; i < image->globals_size; i++) {
+        AST_T* vdef = init_ast(runtime->arena, AST_VARIABLE_DEFINITION);
+        vdef->var_def_var_name = runtime->globals.names[i];
+        vdef->var_def_value = init_ast(runtime->arena, AST_NOOP);
+        vdef->var_def_index = i;
+        scope_add_var_def(scope, vdef);
+    }
+
+    for (size_t i = 0; i < image->fdefs_size; i++) {
+        AST_T* fdef = image->fdefs[i];
+
+        if (fdef == NULL) {
+            fdef = init_ast(runtime->arena, AST_FUNCTION_DEFINITION);
+            fdef->fn_def_name = runtime->functions.names[i];
+            fdef->fn_def_body = init_ast(runtime->arena, AST_NOOP);
+            fdef->fn_def_index = i;
+        }
+
+        scope_add_fn_def(scope, fdef);
+    }
+}
+
+/**
+ * @brief Puts the definitions of the restored functions in front of
+ *        the statements of a program, for the virtual machine, which
+ *        binds functions by running their definitions.
+ *
+ * @param[in] image Pointer to the image struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return root Returns the root node of the program with the
+ *         definitions in front.
+ */
+AST_T* image_prepend_definitions(image_T* image, AST_T* root) {
+    size_t size = 0;
+
+    for (size_t i = 0; i < image->fdefs_size; i++) {
+        size += image->fdefs[i] != NULL;
+    }
+
+    AST_T* compound = init_ast_list(image->runtime->arena, AST_COMPOUND, size + root->compound_size);
+    compound->scope = root->scope;
+    size = 0;
+
+    for (size_t i = 0; i < image->fdefs_size; i++) {
+        if (image->fdefs[i] != NULL) {
+            compound->compound_value[size++] = image->fdefs[i];
+        }
+    }
+
+    memcpy(compound->compound_value + size, root->compound_value, root->compound_size * sizeof(struct AST_STRUCT*));
+
+    return compound;
+}
+
+/**
+ * @brief Unmaps an image. The functions it restored must not run
+ *        anymore.
+ *
+ * @param[in] image Pointer to the image struct.
+ * @return void Does not return.
+ */
+void image_free(image_T* image) {
+    munmap(image->map, image->size);
+    free(image->fdefs);
+    free(image);
+}
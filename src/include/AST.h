@@ -1,7 +1,16 @@
 #ifndef AST_H
 #define AST_H
 #include <stdlib.h>
+#include <stdint.h>
+#include "arena.h"
+#include "value.h"
 
+/**
+ * Nodes are only allocated as large as their type needs, so only
+ * the fields of the node type may be accessed and nodes must never
+ * be copied by value. Names and string values are interned.
+ * The indices of definitions, variables and calls are set by the resolver.
+ */
 typedef struct AST_STRUCT
 {
     enum {
@@ -10,44 +19,158 @@ typedef struct AST_STRUCT
         AST_VARIABLE,
         AST_FUNCTION_CALL,
         AST_STRING,
+        AST_INTEGER,
+        AST_FLOAT,
+        AST_BOOLEAN,
+        AST_BINARY,
+        AST_NEGATE,
         AST_COMPOUND,
         AST_NOOP
     } type;
 
     struct SCOPE_STRUCT* scope;
 
-    /* AST_VARIABLE_DEFINITION */
-    char* var_def_var_name;
-    struct AST_STRUCT* var_def_value;
+    union {
+        /* AST_VARIABLE_DEFINITION */
+        struct {
+            const char* var_def_var_name;
+            struct AST_STRUCT* var_def_value;
+            size_t var_def_index;
+        };
+
+        /* AST_FUNCTION_DEFINITION */
+        struct {
+            struct AST_STRUCT* fn_def_body;
+            const char* fn_def_name;
+            struct AST_STRUCT** fn_def_args;
+            size_t fn_def_args_size;
+            size_t fn_def_index;
+        };
+
+        /* AST_VARIABLE */
+        struct {
+            const char* var_name;
+            /* Slot in the frame of the call when local, otherwise
+               the index of the global. */
+            int var_local;
+            size_t var_index;
+        };
+
+        /* AST_FUNCTION_CALL */
+        struct {
+            const char* fn_call_name;
+            struct AST_STRUCT** fn_call_args;
+            size_t fn_call_args_size;
+            /* Set when the call is bound to a builtin, the index
+               is then the index of the builtin, not of a global. */
+            int fn_call_builtin;
+            size_t fn_call_index;
+            /* Inline cache of the called definition, valid while the
+               version matches the functions version of the runtime. */
+            struct AST_STRUCT* fn_call_fdef;
+            size_t fn_call_version;
+        };
 
-    /* AST_FUNCTION_DEFINITION */
-    struct AST_STRUCT* fn_def_body;
-    char* fn_def_name;
-    struct AST_STRUCT** fn_def_args;
-    size_t fn_def_args_size;
+        /* AST_STRING */
+        struct {
+            const char* string_value;
+        };
 
-    /* AST_VARIABLE */
-    char* var_name;
+        /* AST_INTEGER */
+        struct {
+            int32_t integer_value;
+        };
 
-    /* AST_FUNCTION_CALL */
-    char* fn_call_name;
-    struct AST_STRUCT** fn_call_args;
-    size_t fn_call_args_size;
+        /* AST_FLOAT */
+        struct {
+            double float_value;
+        };
 
-    /* AST_STRING */
-    char* string_value;
+        /* AST_BOOLEAN */
+        struct {
+            int boolean_value;
+        };
 
-    /* AST_COMPOUND */
-    struct AST_STRUCT** compound_value;
-    size_t compound_size;
+        /* AST_BINARY */
+        struct {
+            value_op_T binary_op;
+            struct AST_STRUCT* binary_left;
+            struct AST_STRUCT* binary_right;
+        };
+
+        /* AST_NEGATE */
+        struct {
+            struct AST_STRUCT* negate_value;
+        };
+
+        /* AST_COMPOUND */
+        struct {
+            struct AST_STRUCT** compound_value;
+            size_t compound_size;
+        };
+    };
 } AST_T;
 
+/* Amount of node types. */
+#define AST_TYPES (AST_NOOP + 1)
+
+/* Name of each node type. */
+extern const char* const ast_type_names[];
+
 /**
  * @brief Initializes and allocates the abstract syntax tree by setting
  *        the type, and setting the remaining values to NULL or 0.
  * 
+ * @param[in] arena Pointer to the arena the node is allocated from.
  * @param[in] type Integer value of the node type.
  * @return parser Returns newly allocated abstract syntax tree.
  */
-AST_T* init_ast(int type);
+AST_T* init_ast(arena_T* arena, int type);
+
+/**
+ * @brief Initializes and allocates a function definition, function
+ *        call or compound node together with its list of child nodes.
+ *        The list is stored right behind the node and its size is set.
+ * 
+ * @param[in] arena Pointer to the arena the node is allocated from.
+ * @param[in] type Integer value of the node type.
+ * @param[in] size Amount of child nodes in the list.
+ * @return parser Returns newly allocated abstract syntax tree.
+ */
+AST_T* init_ast_list(arena_T* arena, int type, size_t size);
+
+/**
+ * @brief Gives the size of a node of a type, up to its list of child
+ *        nodes, which is aligned to hold pointers.
+ * 
+ * @param[in] type Integer value of the node type.
+ * @return size Returns the size in bytes of the node.
+ */
+size_t ast_node_size(int type);
+
+/**
+ * @brief Initializes and allocates the literal node of a value.
+ *        Only strings, numbers and booleans have a literal.
+ * 
+ * @param[in] arena Pointer to the arena the node is allocated from.
+ * @param[in] value Value of the literal.
+ * @return parser Returns newly allocated abstract syntax tree.
+ */
+AST_T* init_ast_literal(arena_T* arena, value_T value);
+
+/**
+ * @brief Tells whether the node is a string, number or boolean literal.
+ * 
+ * @param[in] node Pointer to the node.
+ * @return int Returns 1 for literals, 0 otherwise.
+ */
+int ast_is_literal(AST_T* node);
+
+/**
+ * @brief Gives the value of a literal node.
+ * 
+ * @param[in] node Pointer to the literal node.
+ * @return value Returns the value of the literal.
+ */
+value_T ast_literal_value(AST_T* node);
 #endif
@@ -0,0 +1,87 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (1 << 20)
+#define ARENA_ALIGNMENT 8
+
+typedef struct ARENA_BLOCK_STRUCT
+{
+    struct ARENA_BLOCK_STRUCT* prev;
+    size_t size;
+    size_t used;
+    char data[];
+} arena_block_T;
+
+typedef struct ARENA_STRUCT
+{
+    arena_block_T* block;
+    size_t block_size;
+
+    /* Allocations handed out and their bytes, for statistics. */
+    size_t allocations;
+    size_t allocated;
+} arena_T;
+
+/**
+ * @brief Initializes and allocates an arena. Memory is handed out
+ *        from large blocks by bumping a pointer and is only ever
+ *        released all at once by arena_reset or arena_free.
+ * 
+ * @param[in] block_size Size in bytes of each block, 0 for the default.
+ * @return arena Returns newly allocated arena.
+ */
+arena_T* init_arena(size_t block_size);
+
+/**
+ * @brief Allocates zeroed memory from the arena. Allocations that
+ *        would waste most of a block get a block of their own.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @param[in] size Size in bytes of the allocation.
+ * @return ptr Returns pointer to the allocated memory.
+ */
+void* arena_alloc(arena_T* arena, size_t size);
+
+/**
+ * @brief Grows an allocation. The memory is extended in place when it
+ *        is the last allocation of the current block, otherwise it
+ *        is copied into a new allocation.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @param[in] ptr Pointer to the allocation, or NULL.
+ * @param[in] old_size Size in bytes of the allocation.
+ * @param[in] new_size Size in bytes the allocation needs.
+ * @return ptr Returns pointer to the grown allocation.
+ */
+void* arena_realloc(arena_T* arena, void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Copies a string of a given length into the arena
+ *        and NUL-terminates it.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @param[in] str String to copy.
+ * @param[in] length Amount of characters to copy.
+ * @return str Returns the copied String.
+ */
+char* arena_strndup(arena_T* arena, const char* str, size_t length);
+
+/**
+ * @brief Releases everything allocated from the arena at once. The
+ *        first block is kept and zeroed as far as it was used, so the
+ *        arena can be reused without allocating and zeroing a block.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @return void Does not return.
+ */
+void arena_reset(arena_T* arena);
+
+/**
+ * @brief Releases every block of the arena and the arena itself.
+ * 
+ * @param[in] arena Pointer to the arena struct.
+ * @return void Does not return.
+ */
+void arena_free(arena_T* arena);
+#endif
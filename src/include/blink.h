@@ -0,0 +1,121 @@
+#ifndef BLINK_H
+#define BLINK_H
+#include <stddef.h>
+#include "runtime.h"
+#include "scope.h"
+
+/**
+ * Interpreter embedded in a host program, built as libblink.a and
+ * libblink.so. Every instance owns its runtime, with its arena,
+ * interner, globals and builtins, and nothing is shared between
+ * instances, so a host may keep one per thread. A single instance is
+ * not safe to use from several threads at once, and must not be used
+ * from the natives it calls.
+ *
+ * Programs run on the tree walker. Errors do not exit the host, the
+ * call that ran into one returns 0 and blink_error gives its message.
+ */
+typedef struct BLINK_STRUCT
+{
+    runtime_T* runtime;
+
+    /* Names defined so far, every evaluation sees the definitions
+       of the ones before it. */
+    scope_T* scope;
+} blink_T;
+
+/**
+ * @brief Initializes and allocates an interpreter instance with a
+ *        runtime of its own.
+ *
+ * @param[in] NONE
+ * @return blink Returns newly allocated instance.
+ */
+blink_T* init_blink();
+
+/**
+ * @brief Evaluates a program in the instance. Its definitions stay
+ *        defined for later evaluations and calls.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] contents Characters of the program, not NUL-terminated.
+ * @param[in] length Amount of characters in the program.
+ * @return int Returns 1 when the program ran, 0 on an error.
+ */
+int blink_eval_string(blink_T* blink, const char* contents, size_t length);
+
+/**
+ * @brief Evaluates the program of a file in the instance.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] filepath String of path to source file.
+ * @return int Returns 1 when the program ran, 0 on an error.
+ */
+int blink_eval_file(blink_T* blink, const char* filepath);
+
+/**
+ * @brief Calls a function defined by an earlier evaluation.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] name String of the function name.
+ * @param[in] args Values of the arguments, strings from blink_string.
+ * @param[in] args_size Amount of arguments.
+ * @param[out] result Value of the call, or NULL.
+ * @return int Returns 1 when the function ran, 0 on an error.
+ */
+int blink_call(blink_T* blink, const char* name, value_T* args, size_t args_size, value_T* result);
+
+/**
+ * @brief Gives a string value of the instance. It stays valid until
+ *        the instance is reset or released.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] str String to intern.
+ * @param[in] length Amount of characters in the string.
+ * @return value Returns the string value.
+ */
+value_T blink_string(blink_T* blink, const char* str, size_t length);
+
+/**
+ * @brief Registers a native function that programs can call by name.
+ *        Only programs evaluated after the registration see it, and
+ *        it stays registered when the instance is reset. A native
+ *        reports an error with runtime_error.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @param[in] name String of the name the native is called by.
+ * @param[in] fn Pointer to the native function.
+ * @param[in] arity Amount of arguments, the least amount if variadic.
+ * @param[in] flags BUILTIN_VARIADIC or 0.
+ * @return void Does not return.
+ */
+void blink_register(blink_T* blink, const char* name, builtin_fn_T fn, size_t arity, int flags);
+
+/**
+ * @brief Gives the message of the error of the last call that failed.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return message Returns the message, empty if there was none.
+ */
+const char* blink_error(blink_T* blink);
+
+/**
+ * @brief Forgets every definition and value of the instance, keeping
+ *        the natives it registered and the configuration of its
+ *        runtime. Its memory is kept for the next programs, which
+ *        makes a reset much cheaper than a new instance.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return void Does not return.
+ */
+void blink_reset(blink_T* blink);
+
+/**
+ * @brief Flushes what the programs printed and releases the runtime
+ *        of the instance and the instance itself.
+ *
+ * @param[in] blink Pointer to the instance.
+ * @return void Does not return.
+ */
+void blink_free(blink_T* blink);
+#endif
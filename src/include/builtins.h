@@ -0,0 +1,72 @@
+#ifndef BUILTINS_H
+#define BUILTINS_H
+#include <stddef.h>
+#include "value.h"
+
+struct RUNTIME_STRUCT;
+
+/* The builtin takes any amount of arguments from its arity on. */
+#define BUILTIN_VARIADIC 1
+
+/**
+ * Native function. The arguments are evaluated before the call and
+ * only stay valid until it returns.
+ */
+typedef value_T (*builtin_fn_T)(struct RUNTIME_STRUCT* runtime, value_T* args, size_t args_size);
+
+typedef struct BUILTIN_STRUCT
+{
+    /* Interned name the builtin is called by. */
+    const char* name;
+    builtin_fn_T fn;
+    size_t arity;
+    int flags;
+} builtin_T;
+
+/* Builtins of a runtime, calls refer to them by index. */
+typedef struct BUILTINS_STRUCT
+{
+    builtin_T* entries;
+    size_t size;
+    size_t capacity;
+} builtins_T;
+
+/**
+ * @brief Registers the builtins every runtime starts with.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void builtins_register_defaults(struct RUNTIME_STRUCT* runtime);
+
+/**
+ * @brief Finds the builtin with the name.
+ * 
+ * @param[in] builtins Pointer to the builtins.
+ * @param[in] name Interned string of the name.
+ * @return index Returns the index of the builtin, or -1 if there is none.
+ */
+long builtins_find(builtins_T* builtins, const char* name);
+
+/**
+ * @brief Builtin for Blink's print function, prints every argument
+ *        on its own line.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] args Values of the arguments.
+ * @param[in] args_size Amount of arguments.
+ * @return value Returns nil.
+ */
+value_T builtin_fn_print(struct RUNTIME_STRUCT* runtime, value_T* args, size_t args_size);
+
+/**
+ * @brief Builtin for Blink's flush function, writes everything
+ *        that was printed but is still buffered.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] args Values of the arguments.
+ * @param[in] args_size Amount of arguments.
+ * @return value Returns nil.
+ */
+value_T builtin_fn_flush(struct RUNTIME_STRUCT* runtime, value_T* args, size_t args_size);
+#endif
@@ -0,0 +1,133 @@
+#ifndef CACHE_H
+#define CACHE_H
+#include <stdint.h>
+#include "chunk.h"
+#include "runtime.h"
+
+/* Version of the compiled programs the interpreter reads and writes.
+   Bump it whenever the instructions, the values or the layout of the
+   file change, so that older files are compiled again. */
+#define CACHE_VERSION 1
+
+#define CACHE_MAGIC "BLINKC\n"
+#define CACHE_BYTE_ORDER 0x01020304
+
+/**
+ * A compiled program is the chunk as it is in memory, with every
+ * pointer replaced by an offset. Sections are an offset from the start
+ * of the file and an amount of elements, aligned to 8 bytes:
+ *
+ *   code              bytes of the code
+ *   constants         value_T, a string holds the offset of its text
+ *                     in the strings section instead of a pointer
+ *   functions         chunk_function_T, the name is an offset in the
+ *                     strings section, all ones for the top level,
+ *                     and the chunk is NULL
+ *   call_caches       chunk_call_cache_T, all empty
+ *   globals           uint64_t offsets of the names of the globals
+ *   function_globals  uint64_t offsets of the names of the functions
+ *   builtins          uint64_t offsets of the names of the builtins
+ *                     the program was bound to
+ *   strings           NUL-terminated texts, each one only once so
+ *                     that strings stay equal by identity
+ */
+typedef struct CACHE_HEADER_STRUCT
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t pointer_size;
+    uint32_t reserved;
+
+    /* The source the program was compiled from. */
+    uint64_t source_hash;
+    uint64_t source_length;
+
+    uint64_t code;
+    uint64_t code_size;
+    uint64_t constants;
+    uint64_t constants_size;
+    uint64_t functions;
+    uint64_t functions_size;
+    uint64_t call_caches;
+    uint64_t call_caches_size;
+    uint64_t globals;
+    uint64_t globals_size;
+    uint64_t function_globals;
+    uint64_t function_globals_size;
+    uint64_t builtins;
+    uint64_t builtins_size;
+    uint64_t strings;
+    uint64_t strings_size;
+} cache_header_T;
+
+/* Compiled program mapped from a file, its chunk points into the
+   mapping until the cache is released. */
+typedef struct CACHE_STRUCT
+{
+    void* map;
+    size_t size;
+    chunk_T* chunk;
+} cache_T;
+
+/**
+ * @brief Hashes a source together with the version of the compiled
+ *        programs, the key of the compiled program of the source.
+ *
+ * @param[in] contents Characters of the source.
+ * @param[in] length Amount of characters in the source.
+ * @return key Returns the key of the source.
+ */
+uint64_t cache_key(const char* contents, size_t length);
+
+/**
+ * @brief Gives the path of the compiled program of a source. Without
+ *        a directory it lies next to the source, a .blink source gets
+ *        a .blinkc file. In a directory it is named after the key.
+ *
+ * @param[in] filename Path of the source.
+ * @param[in] dir Directory of compiled programs, or NULL.
+ * @param[in] key Key of the source.
+ * @return path Returns the newly allocated path.
+ */
+char* cache_path(const char* filename, const char* dir, uint64_t key);
+
+/**
+ * @brief Maps a compiled program and binds its globals in the runtime,
+ *        which must not have bound any yet. The program is only used
+ *        when it was compiled from the same source by the same
+ *        version, for the same builtins.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the compiled program.
+ * @param[in] key Key of the source.
+ * @param[in] length Amount of characters in the source.
+ * @return cache Returns the mapped program, or NULL when there is
+ *         none that can be used.
+ */
+cache_T* cache_load(runtime_T* runtime, const char* path, uint64_t key, size_t length);
+
+/**
+ * @brief Writes the compiled program of a source, together with the
+ *        globals and builtins the runtime bound it to. The file is
+ *        replaced at once, so that no run maps a partly written one.
+ *        A program that cannot be written is compiled again next time.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] chunk Pointer to the compiled program.
+ * @param[in] path Path of the compiled program.
+ * @param[in] key Key of the source.
+ * @param[in] length Amount of characters in the source.
+ * @return void Does not return.
+ */
+void cache_store(runtime_T* runtime, chunk_T* chunk, const char* path, uint64_t key, size_t length);
+
+/**
+ * @brief Unmaps a compiled program. Its chunk must not be used
+ *        anymore.
+ *
+ * @param[in] cache Pointer to the cache struct.
+ * @return void Does not return.
+ */
+void cache_free(cache_T* cache);
+#endif
@@ -0,0 +1,151 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+#include <stdint.h>
+#include "AST.h"
+#include "arena.h"
+#include "value.h"
+
+/**
+ * Instructions are a one byte opcode followed by 32-bit operands.
+ * Every expression leaves exactly one value on the stack.
+ */
+typedef enum {
+    OP_CONSTANT,    /* constant      push constants[constant] */
+    OP_NIL,         /*               push nil */
+    OP_POP,         /*               pop */
+    OP_GET_LOCAL,   /* slot          push the argument in slot */
+    OP_GET_GLOBAL,  /* global        push the value of the global */
+    OP_SET_GLOBAL,  /* global        pop into the global */
+    OP_DEFINE_FN,   /* global, fn    bind functions[fn] to the global */
+    OP_CALL,        /* global, argc, cache
+                                     call the function global */
+    OP_TAIL_CALL,   /* global, argc, cache
+                                     call the function global in place
+                                     of the current call */
+    OP_CALL_BUILTIN,/* builtin, argc pass and pop argc values, push the result */
+    OP_RETURN,      /*               return the top of the stack */
+    OP_NEGATE,      /*               negate the top of the stack */
+    /* Binary operators pop the right and the left operand and push
+       the result, in the order of value_op_T. */
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_EQUAL,
+    OP_NOT_EQUAL,
+    OP_LESS,
+    OP_GREATER,
+    OP_LESS_EQUAL,
+    OP_GREATER_EQUAL,
+} opcode_T;
+
+/* Compiled function, its code starts at entry of the code of its
+   chunk. Function 0 of a chunk is the top level of the program. */
+typedef struct CHUNK_FUNCTION_STRUCT
+{
+    struct CHUNK_STRUCT* chunk;
+    const char* name;
+    size_t arity;
+    size_t entry;
+    /* Most values the code has on the stack at once. */
+    size_t max_stack;
+} chunk_function_T;
+
+/* Inline cache of a call site, valid while the version matches the
+   functions version of the virtual machine. */
+typedef struct CHUNK_CALL_CACHE_STRUCT
+{
+    chunk_function_T* function;
+    size_t version;
+} chunk_call_cache_T;
+
+typedef struct CHUNK_STRUCT
+{
+    arena_T* arena;
+
+    uint8_t* code;
+    size_t code_size;
+    size_t code_capacity;
+
+    /* Values the code refers to by index. */
+    value_T* constants;
+    size_t constants_size;
+    size_t constants_capacity;
+
+    chunk_function_T* functions;
+    size_t functions_size;
+    size_t functions_capacity;
+
+    /* One for every call site, they start out empty. */
+    chunk_call_cache_T* call_caches;
+    size_t call_caches_size;
+    size_t call_caches_capacity;
+} chunk_T;
+
+/**
+ * @brief Initializes and allocates an empty chunk of bytecode.
+ * 
+ * @param[in] arena Pointer to the arena the chunk grows in.
+ * @return chunk Returns newly allocated chunk.
+ */
+chunk_T* init_chunk(arena_T* arena);
+
+/**
+ * @brief Appends an opcode to the code.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] op Opcode to append.
+ * @return void Does not return.
+ */
+void chunk_write_op(chunk_T* chunk, opcode_T op);
+
+/**
+ * @brief Appends a 32-bit operand to the code.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] operand Operand to append.
+ * @return void Does not return.
+ */
+void chunk_write_operand(chunk_T* chunk, size_t operand);
+
+/**
+ * @brief Reads the 32-bit operand at an offset of the code.
+ * 
+ * @param[in] code Pointer to the operand.
+ * @return operand Returns the operand.
+ */
+static inline uint32_t chunk_read_operand(const uint8_t* code) {
+    uint32_t operand;
+    __builtin_memcpy(&operand, code, sizeof(operand));
+
+    return operand;
+}
+
+/**
+ * @brief Adds a value to the constants.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] value Value of the constant.
+ * @return index Returns the index of the constant.
+ */
+size_t chunk_add_constant(chunk_T* chunk, value_T value);
+
+/**
+ * @brief Adds a function whose code has not been compiled yet.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @param[in] name Interned string of the function name.
+ * @param[in] arity Amount of arguments of the function.
+ * @return index Returns the index of the function.
+ */
+size_t chunk_add_function(chunk_T* chunk, const char* name, size_t arity);
+
+/**
+ * @brief Adds the inline cache of a call site.
+ * 
+ * @param[in] chunk Pointer to the chunk struct.
+ * @return index Returns the index of the cache.
+ */
+size_t chunk_add_call_cache(chunk_T* chunk);
+#endif
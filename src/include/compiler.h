@@ -0,0 +1,69 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+#include "AST.h"
+#include "chunk.h"
+#include "runtime.h"
+
+typedef struct COMPILER_STRUCT
+{
+    runtime_T* runtime;
+    chunk_T* chunk;
+
+    /* Definitions of the functions of the chunk, their bodies are
+       compiled after the code that defines them. */
+    AST_T** fdefs;
+    size_t fdefs_size;
+    size_t fdefs_capacity;
+
+    /* Values on the stack at the current instruction of the function
+       being compiled, and the most so far. */
+    size_t depth;
+    size_t max_depth;
+} compiler_T;
+
+/**
+ * @brief Initializes and allocates the compiler.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return compiler Returns newly allocated compiler.
+ */
+compiler_T* init_compiler(runtime_T* runtime);
+
+/**
+ * @brief Compiles a resolved program into a new chunk of bytecode.
+ *        Function 0 of the chunk runs the top level of the program.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return chunk Returns newly allocated chunk.
+ */
+chunk_T* compiler_compile(compiler_T* compiler, AST_T* root);
+
+/**
+ * @brief Compiles a function body. A call in tail position replaces
+ *        the call of the body, otherwise the body returns nil.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] body Pointer to the compound of the function body.
+ * @return void Does not return.
+ */
+void compiler_compile_body(compiler_T* compiler, AST_T* body);
+
+/**
+ * @brief Compiles a statement, which leaves the stack as it was.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] node Pointer to the statement node.
+ * @return void Does not return.
+ */
+void compiler_compile_statement(compiler_T* compiler, AST_T* node);
+
+/**
+ * @brief Compiles an expression, which pushes exactly one value.
+ * 
+ * @param[in] compiler Pointer to the compiler struct.
+ * @param[in] node Pointer to the expression node.
+ * @return void Does not return.
+ */
+void compiler_compile_expr(compiler_T* compiler, AST_T* node);
+#endif
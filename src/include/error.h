@@ -0,0 +1,52 @@
+#ifndef ERROR_H
+#define ERROR_H
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+
+/* Longest message kept of an error, the rest is cut off. */
+#define ERROR_MESSAGE_SIZE 256
+
+/* Where errors go. Without a jump they are printed and the process
+   exits, as the interpreter does. A host that embeds the interpreter
+   sets a jump to get back control instead, with the message of the
+   first error that was reported since. */
+typedef struct ERROR_STRUCT
+{
+    jmp_buf* jump;
+    char message[ERROR_MESSAGE_SIZE];
+    size_t count;
+} error_T;
+
+/**
+ * @brief Reports an error. Without a jump the message is printed on
+ *        its own line, otherwise the first message is kept.
+ *
+ * @param[in] error Pointer to the error struct, or NULL to print.
+ * @param[in] format Format string of the message, without newline.
+ * @return void Does not return.
+ */
+void error_report(error_T* error, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Reports an error with the arguments of the format in a list.
+ *
+ * @param[in] error Pointer to the error struct, or NULL to print.
+ * @param[in] format Format string of the message, without newline.
+ * @param[in] args Arguments of the format.
+ * @return void Does not return.
+ */
+void error_vreport(error_T* error, const char* format, va_list args);
+
+/**
+ * @brief Gives up after the reported errors. Jumps back to the host
+ *        when there is a jump, otherwise exits.
+ *
+ * @param[in] error Pointer to the error struct, or NULL to exit.
+ * @param[in] status Exit status when there is no jump.
+ * @return void Does not return.
+ */
+void error_raise(error_T* error, int status)
+    __attribute__((noreturn));
+#endif
@@ -0,0 +1,71 @@
+#ifndef FOLDER_H
+#define FOLDER_H
+#include "AST.h"
+#include "runtime.h"
+
+typedef struct FOLDER_STRUCT
+{
+    runtime_T* runtime;
+
+    /* Amount of definitions of every variable global. */
+    size_t* definitions;
+
+    /* Literal that every variable global is known to hold from here
+       on in the program, or NULL. */
+    AST_T** constants;
+
+    /* First global bound by the program. The ones before it were bound
+       by earlier programs, whose functions may define them again, so
+       they are never folded. */
+    size_t first_global;
+
+    /* Set when the functions of the program outlive it, as in an image
+       or an embedded instance, where a later program may define their
+       variables again. Their bodies are then left unfolded. */
+    int persistent;
+
+    /* Amount of function definitions around the visited node. */
+    size_t functions;
+} folder_T;
+
+/**
+ * @brief Initializes and allocates the folder.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return folder Returns newly allocated folder.
+ */
+folder_T* init_folder(runtime_T* runtime);
+
+/**
+ * @brief Folds a resolved program. Operations on literals are replaced
+ *        by the literal of their result, unless they would fail at
+ *        runtime. A variable that is defined once, by a top level
+ *        statement with a literal value, is replaced by that literal
+ *        wherever it is used after the definition, unless an earlier
+ *        program bound it, and not inside of functions if the folder
+ *        is persistent.
+ * 
+ * @param[in] folder Pointer to the folder struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return void Does not return.
+ */
+void folder_fold(folder_T* folder, AST_T* root);
+
+/**
+ * @brief Counts the definitions of every variable global below a node.
+ * 
+ * @param[in] folder Pointer to the folder struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void folder_count(folder_T* folder, AST_T* node);
+
+/**
+ * @brief Folds the node and everything below it.
+ * 
+ * @param[in] folder Pointer to the folder struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return AST_T Returns the folded node, which replaces the visited one.
+ */
+AST_T* folder_fold_node(folder_T* folder, AST_T* node);
+#endif
@@ -0,0 +1,132 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+#include <stdint.h>
+#include "AST.h"
+#include "scope.h"
+#include "runtime.h"
+
+/* Version of the images the interpreter reads and writes. Bump it
+   whenever the nodes, the values or the layout of the file change. */
+#define IMAGE_VERSION 1
+
+#define IMAGE_MAGIC "BLINKI\n"
+#define IMAGE_BYTE_ORDER 0x01020304
+
+/**
+ * An image is the state a program leaves in the runtime: its globals
+ * with their values and its functions with the nodes of their
+ * definitions. Sections are an offset from the start of the file and
+ * a size, aligned to 8 bytes:
+ *
+ *   nodes      every node reachable from a function, as it is in
+ *              memory with its list of child nodes right behind it.
+ *              Pointers to nodes are offsets from the start of the
+ *              file, pointers to strings offsets in the strings
+ *              section, the scope is NULL and the inline cache of a
+ *              call is empty
+ *   globals    image_entry_T of every global, a string value holds
+ *              the offset of its text instead of a pointer
+ *   functions  image_entry_T of every function global, the value is
+ *              the offset of its definition, 0 when undefined
+ *   builtins   uint64_t offsets of the names of the builtins the
+ *              calls were bound to
+ *   strings    NUL-terminated texts
+ *
+ * The sizes of nodes and strings are in bytes, the others in entries.
+ */
+typedef struct IMAGE_HEADER_STRUCT
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t pointer_size;
+    uint32_t reserved;
+
+    uint64_t nodes;
+    uint64_t nodes_size;
+    uint64_t globals;
+    uint64_t globals_size;
+    uint64_t functions;
+    uint64_t functions_size;
+    uint64_t builtins;
+    uint64_t builtins_size;
+    uint64_t strings;
+    uint64_t strings_size;
+} image_header_T;
+
+typedef struct IMAGE_ENTRY_STRUCT
+{
+    uint64_t name;
+    uint64_t value;
+} image_entry_T;
+
+/* Image mapped into a runtime, the functions it restored run their
+   nodes from the mapping until the image is released. */
+typedef struct IMAGE_STRUCT
+{
+    runtime_T* runtime;
+    void* map;
+    size_t size;
+
+    /* Amount of restored globals, they come first in the runtime. */
+    size_t globals_size;
+
+    /* Definition of every restored function global, NULL when it
+       was undefined. */
+    AST_T** fdefs;
+    size_t fdefs_size;
+} image_T;
+
+/**
+ * @brief Writes the globals and functions of the runtime to an image,
+ *        to start later runs from. The program exits when the image
+ *        cannot be written.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the image.
+ * @return void Does not return.
+ */
+void image_dump(runtime_T* runtime, const char* path);
+
+/**
+ * @brief Maps an image and restores its globals and functions into
+ *        the runtime, which must not have bound any yet. The program
+ *        exits when the image cannot be used.
+ *
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] path Path of the image.
+ * @return image Returns the mapped image.
+ */
+image_T* image_load(runtime_T* runtime, const char* path);
+
+/**
+ * @brief Declares the globals and functions of the image in the scope
+ *        of a program, so that the resolver binds the program to them.
+ *
+ * @param[in] image Pointer to the image struct.
+ * @param[in] scope Pointer to the scope of the program.
+ * @return void Does not return.
+ */
+void image_declare(image_T* image, scope_T* scope);
+
+/**
+ * @brief Puts the definitions of the restored functions in front of
+ *        the statements of a program, for the virtual machine, which
+ *        binds functions by running their definitions.
+ *
+ * @param[in] image Pointer to the image struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return root Returns the root node of the program with the
+ *         definitions in front.
+ */
+AST_T* image_prepend_definitions(image_T* image, AST_T* root);
+
+/**
+ * @brief Unmaps an image. The functions it restored must not run
+ *        anymore.
+ *
+ * @param[in] image Pointer to the image struct.
+ * @return void Does not return.
+ */
+void image_free(image_T* image);
+#endif
@@ -0,0 +1,53 @@
+#ifndef INTERN_H
+#define INTERN_H
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+typedef struct INTERN_ENTRY_STRUCT
+{
+    const char* str;
+    size_t length;
+    uint64_t hash;
+} intern_entry_T;
+
+typedef struct INTERNER_STRUCT
+{
+    arena_T* arena;
+
+    /* Open addressing table, the capacity is a power of two. */
+    intern_entry_T* entries;
+    size_t size;
+    size_t capacity;
+} interner_T;
+
+/**
+ * @brief Initializes and allocates an interner, a set of unique
+ *        strings. Interning the same characters twice returns the
+ *        same pointer, so interned strings compare by pointer.
+ * 
+ * @param[in] arena Pointer to the arena the interner and strings live in.
+ * @return interner Returns newly allocated interner.
+ */
+interner_T* init_interner(arena_T* arena);
+
+/**
+ * @brief Hashes a string of a given length.
+ * 
+ * @param[in] str String to hash.
+ * @param[in] length Amount of characters in the string.
+ * @return hash Returns the 64-bit FNV-1a hash of the string.
+ */
+uint64_t intern_hash(const char* str, size_t length);
+
+/**
+ * @brief Returns the unique copy of a string, copying it into
+ *        the arena the first time it is seen.
+ * 
+ * @param[in] interner Pointer to the interner struct.
+ * @param[in] str String to intern, it does not need to be NUL-terminated.
+ * @param[in] length Amount of characters in the string.
+ * @return str Returns the interned, NUL-terminated string.
+ */
+const char* interner_intern(interner_T* interner, const char* str, size_t length);
+#endif
@@ -1,13 +1,120 @@
 #ifndef IO_H
 #define IO_H
+#include <stddef.h>
+#include "error.h"
+
+/* Size of the output buffer unless configured otherwise. */
+#define OUT_BUFFER_SIZE 65536
+
+/* When buffered output is written. */
+typedef enum {
+    OUT_FLUSH_LINE,     /* at the end of every line */
+    OUT_FLUSH_BLOCK,    /* whenever the buffer is full */
+    OUT_FLUSH_EXPLICIT, /* only when flushed, the buffer grows meanwhile */
+} out_flush_T;
+
+typedef struct OUT_STRUCT
+{
+    int fd;
+    char* buffer;
+    size_t size;
+    size_t capacity;
+    out_flush_T policy;
+} out_T;
+
+typedef struct SOURCE_STRUCT
+{
+    const char* contents;
+    size_t length;
+    int is_mapped;
+} source_T;
+
+/**
+ * @brief Loads a blink source file. Regular files are memory-mapped
+ *        read-only with a sequential access hint, so the contents are
+ *        never copied and their pages are shared between every process
+ *        running the same file. Anything else, such as a pipe, is read
+ *        with get_file_contents. The contents are not NUL-terminated.
+ * 
+ * @param[in] filepath String of path to source file.
+ * @return source Returns newly allocated source. Otherwise, the 
+ *         program will print an error and exit.
+ */
+source_T* get_file_source(const char* filepath);
+
+/**
+ * @brief Loads a blink source file like get_file_source, reporting a
+ *        file that cannot be loaded as an error.
+ * 
+ * @param[in] filepath String of path to source file.
+ * @param[in] error Where a failed load is reported, or NULL to exit.
+ * @return source Returns newly allocated source.
+ */
+source_T* read_file_source(const char* filepath, error_T* error);
+
+/**
+ * @brief Unmaps or frees the contents of a source and the source itself.
+ * 
+ * @param[in] source Pointer to the source struct.
+ * @return void Does not return.
+ */
+void source_free(source_T* source);
 
 /**
  * @brief Reads and returns blink source file.
  * 
  * @param[in] filepath String of path to source file.
+ * @param[out] length Amount of characters read.
  * @return buffer Returns read characters of blink 
- *         source file. Otherwise, the program will print an error and exit.
+ *         source file, NUL-terminated. Otherwise, the program will
+ *         print an error and exit.
  */
-char* get_file_contents(const char* filepath);
+char* get_file_contents(const char* filepath, size_t* length);
 
+/**
+ * @brief Initializes and allocates a buffered output to a file
+ *        descriptor. Terminals are flushed line by line, anything
+ *        else block by block.
+ * 
+ * @param[in] fd File descriptor to write to.
+ * @return out Returns newly allocated output.
+ */
+out_T* init_out(int fd);
+
+/**
+ * @brief Flushes the output, then sets its buffer size and flush policy.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @param[in] capacity Size of the buffer in bytes, at least 1.
+ * @param[in] policy When the buffer is written.
+ * @return void Does not return.
+ */
+void out_configure(out_T* out, size_t capacity, out_flush_T policy);
+
+/**
+ * @brief Copies bytes into the output buffer. Writes that do not fit
+ *        the buffer go out together with it in a single writev.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @param[in] data Bytes to write.
+ * @param[in] length Amount of bytes to write.
+ * @return void Does not return.
+ */
+void out_write(out_T* out, const char* data, size_t length);
+
+/**
+ * @brief Writes everything that is buffered.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @return void Does not return.
+ */
+void out_flush(out_T* out);
+
+/**
+ * @brief Flushes and frees the output.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @return void Does not return.
+ */
+void out_free(out_T* out);
 #endif
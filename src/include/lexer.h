@@ -1,13 +1,31 @@
 #ifndef LEXER_H
 #define LEXER_H
 #include "token.h"
+#include "arena.h"
+#include "intern.h"
+#include "error.h"
+#include <stddef.h>
+
+#define LEXER_FREE_TOKENS 4
 
 
 typedef struct LEXER_STRUCT
 {
     char c;
-    unsigned int i;
-    char* contents;
+    size_t i;
+    const char* contents;
+    size_t length;
+
+    arena_T* arena;
+    interner_T* interner;
+    token_T* free_tokens[LEXER_FREE_TOKENS];
+    size_t free_tokens_size;
+
+    /* Tokens scanned so far, the EOF token included. */
+    size_t tokens;
+
+    /* Where errors of the lexer and parser go, or NULL to exit. */
+    error_T* error;
 } lexer_T;
 
 /**
@@ -16,12 +34,16 @@ typedef struct LEXER_STRUCT
  *        During initialization, the contents are set to the 
  *        contents of the input file, the character index is set 
  *        to 0, and the current character is set to the first character 
- *        of the contents.
+ *        of the contents. The contents do not need to be NUL-terminated,
+ *        the lexer never reads past the given length.
  * 
  * @param[in] contents String of character from the input file
+ * @param[in] length Amount of characters in the contents
+ * @param[in] arena Pointer to the arena the lexer and tokens live in
+ * @param[in] interner Pointer to the interner identifiers and strings go to
  * @return lexer Newly allocated lexer struct
  */
-lexer_T *init_lexer(char* contents);
+lexer_T *init_lexer(const char* contents, size_t length, arena_T* arena, interner_T* interner);
 
 /**
  * @brief Inspects each character ensuring that it is not a NULL 
@@ -35,14 +57,14 @@ lexer_T *init_lexer(char* contents);
 void lexer_advance(lexer_T* lexer);
 
 /**
- * @brief Inspects each character and skips whitespace and newlines. 
- *        If either are encountered then the function lexer_advance 
- *        is called and the pointer is incremented to the next character.
+ * @brief Moves the lexer to an absolute position in the contents
+ *        and updates the current character.
  * 
  * @param[in] lexer Pointer to lexer struct
+ * @param[in] i Index to move to, at most the length of the contents.
  * @return void Does not return.
  */
-void lexer_skip_whitespace(lexer_T* lexer);
+void lexer_seek(lexer_T* lexer, size_t i);
 
 /**
  * @brief Inspects each character and skips whitespace and newlines. 
@@ -52,12 +74,21 @@ void lexer_skip_whitespace(lexer_T* lexer);
  * @param[in] lexer Pointer to lexer struct
  * @return void Does not return.
  */
+void lexer_skip_whitespace(lexer_T* lexer);
+
+/**
+ * @brief Skips whitespace and scans the next token from the contents.
+ *        Exits with an error on characters that do not start a token.
+ * 
+ * @param[in] lexer Pointer to lexer struct
+ * @return token Returns the next token, or an EOF token at the end.
+ */
 token_T *lexer_get_next_token(lexer_T* lexer);
 
 
 /**
- * @brief Inspects each character and adds it to the string as long as
- *        it does not encounter another quote ( " ).
+ * @brief Finds the closing quote ( " ) and spans and interns
+ *        everything between the quotes.
  * 
  * @param[in] lexer Pointer to lexer struct
  * @return token Returns a String token.
@@ -65,8 +96,29 @@ token_T *lexer_get_next_token(lexer_T* lexer);
 token_T* lexer_collect_string(lexer_T* lexer);
 
 /**
- * @brief Inspects each character and adds it to the value
- *        as long as the current character is alphanumeric.
+ * @brief Scans an operator that is one character on its own,
+ *        or two characters when it is followed by `=`.
+ *
+ * @param[in] lexer Pointer to lexer struct
+ * @param[in] type Token type of the operator on its own.
+ * @param[in] type_equals Token type of the operator followed by `=`.
+ * @return token Returns the operator token.
+ */
+token_T* lexer_collect_operator(lexer_T* lexer, int type, int type_equals);
+
+/**
+ * @brief Spans the digits of a number. A fraction or an exponent
+ *        makes it a Float, otherwise it is an Integer. The parser
+ *        converts the span to its value.
+ *
+ * @param[in] lexer Pointer to lexer struct
+ * @return token Returns an Integer or Float token.
+ */
+token_T* lexer_collect_number(lexer_T* lexer);
+
+/**
+ * @brief Scans ahead while the characters are alphanumeric
+ *        and spans and interns them.
  * 
  * @param[in] lexer Pointer to lexer struct
  * @return token Returns an ID token.
@@ -83,10 +135,13 @@ token_T *lexer_collect_id(lexer_T *lexer);
 token_T *lexer_advance_with_token(lexer_T *lexer, token_T *token);
 
 /**
- * @brief Allocates memory for current character and returns.
+ * @brief Hands a token that is no longer referenced back to the
+ *        lexer, so that its memory is reused for a later token.
  * 
  * @param[in] lexer Pointer to lexer struct
- * @return str Returns newly allocated String.
+ * @param[in] token Pointer to token struct
+ * @return void Does not return.
  */
-char *lexer_get_current_char_as_string(lexer_T *lexer);
+void lexer_release_token(lexer_T *lexer, token_T *token);
+
 #endif
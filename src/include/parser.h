@@ -4,6 +4,10 @@
 #include "AST.h"
 #include "scope.h"
 
+/* Deepest nesting of expressions. The passes after the parser recurse
+   over the tree, deeper expressions would run them out of stack. */
+#define PARSER_MAX_DEPTH 1024
+
 
 typedef struct PARSER_STRUCT
 {
@@ -11,6 +15,21 @@ typedef struct PARSER_STRUCT
     token_T* current_token;
     token_T* prev_token;
     scope_T* scope;
+
+    /* Interned keywords, compared by pointer. */
+    const char* keyword_string;
+    const char* keyword_var;
+    const char* keyword_fn;
+    const char* keyword_true;
+    const char* keyword_false;
+
+    /* Nodes of the lists that are being parsed, innermost last. */
+    AST_T** stack;
+    size_t stack_size;
+    size_t stack_capacity;
+
+    /* Nesting of the expression that is being parsed. */
+    size_t depth;
 } parser_T;
 
 /**
@@ -22,6 +41,35 @@ typedef struct PARSER_STRUCT
  */
 parser_T* init_parser(lexer_T* lexer);
 
+/**
+ * @brief Nests the expression that is being parsed one level deeper,
+ *        reporting an error past PARSER_MAX_DEPTH.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @return void Does not return.
+ */
+void parser_enter(parser_T* parser);
+
+/**
+ * @brief Pushes a node of the list that is being parsed.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] node Pointer to the node to push
+ * @return void Does not return.
+ */
+void parser_push(parser_T* parser, AST_T* node);
+
+/**
+ * @brief Pops the nodes pushed since the list started and copies
+ *        them into the list of the node that owns them.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] base Size of the stack when the list started
+ * @param[out] list List with room for every node since base
+ * @return void Does not return.
+ */
+void parser_pop_list(parser_T* parser, size_t base, AST_T** list);
+
 /**
  * @brief Consumes a token and moves to the next if the
  *        current token is the same as the expected token.
@@ -68,6 +116,37 @@ AST_T* parser_parse_statements(parser_T* parser, scope_T* scope);
  */
 AST_T* parser_parse_expr(parser_T* parser, scope_T* scope);
 
+/**
+ * @brief Parses binary operators that bind at least as tightly as the
+ *        given precedence. Operators of the same precedence group to
+ *        the left.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @param[in] precedence Lowest precedence of the operators to parse
+ * @return AST_T Returns an abstract syntax tree node of proper type(s)
+ */
+AST_T* parser_parse_binary(parser_T* parser, scope_T* scope, int precedence);
+
+/**
+ * @brief Parses a negation or a primary expression.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @return AST_T Returns an abstract syntax tree node of proper type(s)
+ */
+AST_T* parser_parse_unary(parser_T* parser, scope_T* scope);
+
+/**
+ * @brief Parses a literal, a name, a definition or an expression
+ *        between parentheses.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @return AST_T Returns an abstract syntax tree node of proper type(s)
+ */
+AST_T* parser_parse_primary(parser_T* parser, scope_T* scope);
+
 /**
  * @brief Parses a function call.
  * 
@@ -114,7 +193,18 @@ AST_T* parser_parse_var(parser_T* parser, scope_T* scope);
 AST_T* parser_parse_string(parser_T* parser, scope_T* scope);
 
 /**
- * @brief Parses a variable definition.
+ * @brief Parses an integer or float literal. Integers that do not fit
+ *        in 32 bits become floats.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @return AST_T Returns an abstract syntax tree node of type integer or float.
+ */
+AST_T* parser_parse_number(parser_T* parser, scope_T* scope);
+
+/**
+ * @brief Parses a definition, a boolean literal or a variable,
+ *        depending on the keyword it starts with.
  * 
  * @param[in] parser Pointer to parser struct
  * @param[in] scope Pointer to scope struct
@@ -0,0 +1,151 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+#include <stdio.h>
+#include <stdint.h>
+#include "arena.h"
+
+/* Totals of one function over every path it was called on. */
+typedef struct PROFILE_FUNCTION_STRUCT
+{
+    const void* key;
+    const char* name;
+    size_t calls;
+    uint64_t inclusive;
+    uint64_t exclusive;
+
+    /* Calls of the function that are active, its inclusive time only
+       counts the outermost of them. */
+    size_t active;
+} profile_function_T;
+
+/* Node of the calling context tree, a function as called on one path
+   of calls from the top level. Times are in nanoseconds. */
+typedef struct PROFILE_NODE_STRUCT
+{
+    profile_function_T* function;
+    struct PROFILE_NODE_STRUCT* parent;
+    struct PROFILE_NODE_STRUCT* child;
+    struct PROFILE_NODE_STRUCT* sibling;
+    size_t calls;
+    uint64_t inclusive;
+    uint64_t exclusive;
+} profile_node_T;
+
+/* Call that is active, innermost last. A tail call is recorded as a
+   call of the function that made it and returns together with it. */
+typedef struct PROFILE_CALL_STRUCT
+{
+    profile_node_T* node;
+    uint64_t start;
+    uint64_t children;
+    int tail;
+} profile_call_T;
+
+typedef struct PROFILER_STRUCT
+{
+    /* Owns every node and function, apart from the arena of the run
+       so that profiling does not show up in its statistics. */
+    arena_T* arena;
+    profile_node_T* root;
+
+    /* Open addressing map from keys to functions, the capacity is
+       a power of two. */
+    profile_function_T** functions;
+    size_t functions_size;
+    size_t functions_capacity;
+
+    profile_call_T* calls;
+    size_t calls_size;
+    size_t calls_capacity;
+} profiler_T;
+
+/**
+ * @brief Initializes and allocates the profiler, with the top level
+ *        of the program as the root of the calling context tree.
+ *
+ * @param[in] NONE
+ * @return profiler Returns newly allocated profiler.
+ */
+profiler_T* init_profiler();
+
+/**
+ * @brief Releases the profiler and everything it recorded.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @return void Does not return.
+ */
+void profiler_free(profiler_T* profiler);
+
+/**
+ * @brief Starts timing the top level of the program.
+ *
+ * @param[in] profiler Pointer to the profiler struct, or NULL when
+ *            the run is not profiled.
+ * @return void Does not return.
+ */
+void profiler_start(profiler_T* profiler);
+
+/**
+ * @brief Stops timing the top level of the program, together with
+ *        every call that is still active.
+ *
+ * @param[in] profiler Pointer to the profiler struct, or NULL when
+ *            the run is not profiled.
+ * @return void Does not return.
+ */
+void profiler_stop(profiler_T* profiler);
+
+/**
+ * @brief Records the start of a call, as a child of the call that
+ *        is active.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] key Identity of the called function.
+ * @param[in] name Interned name of the called function.
+ * @return void Does not return.
+ */
+void profiler_enter(profiler_T* profiler, const void* key, const char* name);
+
+/**
+ * @brief Records the start of a tail call, as a child of the call
+ *        that makes it. When the function is already called by the
+ *        chain of tail calls that leads here, the chain is cut back to
+ *        that call instead, so that a loop of tail calls stays flat.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] key Identity of the called function.
+ * @param[in] name Interned name of the called function.
+ * @return void Does not return.
+ */
+void profiler_tail(profiler_T* profiler, const void* key, const char* name);
+
+/**
+ * @brief Records the end of the call that is active, and of the
+ *        calls whose tail calls led to it.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @return void Does not return.
+ */
+void profiler_exit(profiler_T* profiler);
+
+/**
+ * @brief Prints the calls, inclusive and exclusive time of every
+ *        function, the functions with the most exclusive time first.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] file File to print to.
+ * @return void Does not return.
+ */
+void profiler_print_summary(profiler_T* profiler, FILE* file);
+
+/**
+ * @brief Writes every path of calls as a collapsed stack, the names
+ *        separated by semicolons and followed by the exclusive time
+ *        of the path in nanoseconds, the input of flame graph tools.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] file File to write to.
+ * @return void Does not return.
+ */
+void profiler_write_collapsed(profiler_T* profiler, FILE* file);
+#endif
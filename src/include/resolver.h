@@ -0,0 +1,69 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+#include "AST.h"
+#include "scope.h"
+#include "runtime.h"
+
+typedef struct RESOLVER_STRUCT
+{
+    runtime_T* runtime;
+    scope_T* scope;
+
+    /* Function definition whose body is being resolved, or NULL. */
+    AST_T* fdef;
+
+    size_t errors;
+} resolver_T;
+
+/**
+ * @brief Initializes and allocates the resolver. The scope is used
+ *        as the table of global names, every name in it is bound to
+ *        a global of the runtime.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] scope Pointer to the scope struct of the program.
+ * @return resolver Returns newly allocated resolver.
+ */
+resolver_T* init_resolver(runtime_T* runtime, scope_T* scope);
+
+/**
+ * @brief Resolves a parsed program before it runs. Every variable and
+ *        function definition is given the index of a global of the
+ *        runtime, every variable is bound to an argument slot of its
+ *        function or to a global, and every call to a global function.
+ *        Undefined names are reported as errors of the runtime.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return void Does not return.
+ */
+void resolver_resolve(resolver_T* resolver, AST_T* root);
+
+/**
+ * @brief Gives every definition below a node its global index.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void resolver_declare(resolver_T* resolver, AST_T* node);
+
+/**
+ * @brief Binds a call to a builtin and checks its amount of arguments.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] node Pointer to the call node.
+ * @param[in] builtin Index of the builtin.
+ * @return void Does not return.
+ */
+void resolver_bind_builtin(resolver_T* resolver, AST_T* node, size_t builtin);
+
+/**
+ * @brief Binds every variable and call below a node.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void resolver_bind(resolver_T* resolver, AST_T* node);
+#endif
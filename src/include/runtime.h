@@ -1,80 +1,321 @@
 #ifndef RUNTIME_H
 #define RUNTIME_H
 #include "AST.h"
+#include "arena.h"
+#include "intern.h"
+#include "value.h"
+#include "builtins.h"
+#include "io.h"
+#include "profiler.h"
+#include "error.h"
+
+/* Most calls that may be active at once, unless configured otherwise. */
+#define RUNTIME_MAX_DEPTH 100000
+
+/* Native stack the tree walker runs on, for the program itself and
+   for every call it may nest. A call nested in expressions takes more
+   than that, so the walker also stops when the stack left over is
+   down to the margin, which builtins and the error report run on. */
+#define RUNTIME_BASE_STACK_SIZE (1 << 20)
+#define RUNTIME_CALL_STACK_SIZE 1024
+#define RUNTIME_STACK_MARGIN (64 << 10)
+
+/* Activation record of a function call. The arguments of the call
+   are bound to the slots from base up to the arity of the function. */
+typedef struct FRAME_STRUCT
+{
+    AST_T* fdef;
+    size_t base;
+} frame_T;
+
+/* Globals bound by the resolver, with the name of each global and
+   its value, undefined until a definition runs. The value of a
+   function global is its function definition. */
+typedef struct GLOBALS_STRUCT
+{
+    const char** names;
+    value_T* values;
+    size_t size;
+    size_t capacity;
+} globals_T;
 
 typedef struct RUNTIME_STRUCT
 {
+    /* Owns every token, node and scope of a run. */
+    arena_T* arena;
+    interner_T* interner;
+
+    builtins_T builtins;
+
+    /* Everything programs print goes through this buffer. */
+    out_T* out;
+
+    /* Records every call of a function of the program, or NULL. */
+    profiler_T* profiler;
+
+    /* Where errors of a run go, see error_T. */
+    error_T error;
+
+    globals_T globals;
+    globals_T functions;
+
+    /* Changes whenever a defined function is replaced, which
+       invalidates the inline cache of every call site. Starts at 1,
+       so call sites that were never cached do not match. */
+    size_t functions_version;
+
+    /* Argument slots of every active call. */
+    value_T* slots;
+    size_t slots_size;
+    size_t slots_capacity;
+
+    /* Active calls, innermost last, at most max_depth of them. */
+    size_t max_depth;
+    frame_T* frames;
+    size_t frames_size;
+    size_t frames_capacity;
+
+    /* Native stack of the tree walker, kept for the next run once it
+       is mapped, below a guard page. */
+    void* stack;
+    size_t stack_size;
+
+    /* Lowest address the walker nests down to while it runs on that
+       stack, or NULL. */
+    char* stack_limit;
 } runtime_T;
 
 /**
  * @brief Initializes and allocates the runtime struct
+ *        together with the arena and interner it owns.
  * 
  * @param[in] NONE
  * @return parser Returns newly allocated runtime.
  */
 runtime_T* init_runtime();
 
+/**
+ * @brief Releases the arena of the runtime, and with it everything
+ *        that was lexed, parsed and run, its call stack, globals and
+ *        the runtime itself.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void runtime_free(runtime_T* runtime);
+
+/**
+ * @brief Forgets everything that was lexed, parsed and run, keeping
+ *        the builtins, the configuration and the memory of the
+ *        runtime for the next program.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void runtime_reset(runtime_T* runtime);
+
+/**
+ * @brief Registers a native function that programs can call by name.
+ *        Calls bind to it when they are resolved, so it must be
+ *        registered before the program that uses it is resolved.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] name String of the name the builtin is called by.
+ * @param[in] fn Pointer to the native function.
+ * @param[in] arity Amount of arguments, the least amount if variadic.
+ * @param[in] flags BUILTIN_VARIADIC or 0.
+ * @return index Returns the index of the builtin.
+ */
+size_t runtime_register_builtin(runtime_T* runtime, const char* name, builtin_fn_T fn, size_t arity, int flags);
+
+/**
+ * @brief Adds a variable global, which stays undefined
+ *        until a definition bound to it runs.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] name Interned string of the variable name.
+ * @return index Returns the index of the new global.
+ */
+size_t runtime_add_global(runtime_T* runtime, const char* name);
+
+/**
+ * @brief Adds a function global, which stays undefined
+ *        until a definition bound to it runs.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] name Interned string of the function name.
+ * @return index Returns the index of the new global.
+ */
+size_t runtime_add_function(runtime_T* runtime, const char* name);
+
+/**
+ * @brief Prints a value on its own line the way the print builtin does.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] value Value to print.
+ * @return void Does not return.
+ */
+void runtime_print_value(runtime_T* runtime, value_T value);
+
+/**
+ * @brief Reports an error of a running program and exits, or jumps
+ *        back to the host when it has set a jump. Everything the
+ *        program printed is flushed before the error.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] format Format string of the message, without newline.
+ * @return void Does not return.
+ */
+void runtime_error(runtime_T* runtime, const char* format, ...)
+    __attribute__((noreturn, format(printf, 2, 3)));
+
+/**
+ * @brief Reports an operation that failed and exits.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] op Name of the operator.
+ * @param[in] status Why the operation failed.
+ * @return void Does not return.
+ */
+void runtime_error_operation(runtime_T* runtime, const char* op, value_status_T status)
+    __attribute__((noreturn));
+
+/**
+ * @brief Runs a resolved program on the tree walker. The walker nests
+ *        on the native stack, so it runs on a thread whose stack is
+ *        sized for the deepest calls the runtime allows, rather than
+ *        on a stack limited by `ulimit -s`.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return value Returns the value of the program.
+ */
+value_T runtime_run(runtime_T* runtime, AST_T* root);
+
+/**
+ * @brief Calls a function of the program with argument values on the
+ *        tree walker, on a thread like runtime_run.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] fdef Pointer to the function definition.
+ * @param[in] args Values of the arguments.
+ * @param[in] args_size Amount of arguments.
+ * @return value Returns the value of the call.
+ */
+value_T runtime_call(runtime_T* runtime, AST_T* fdef, value_T* args, size_t args_size);
+
+/**
+ * @brief Gives the call in tail position of a function body. That is
+ *        a call of a function of the program which is the last
+ *        statement apart from empty ones, its value is nil like the
+ *        value of the body.
+ * 
+ * @param[in] body Pointer to the compound of the function body.
+ * @param[out] size Amount of statements before the call, or of all
+ *             statements if there is no call in tail position.
+ * @return call Returns the call node, or NULL if there is none.
+ */
+AST_T* runtime_tail_call(AST_T* body, size_t* size);
+
 /**
  * @brief Ensures that when the runtime visits a node that the
  *        appropriate action is taken depending on node type.
+ *        The node must have been resolved.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return value Returns the value of the node.
+ */
+value_T runtime_visit(runtime_T* runtime, AST_T* node);
+
+/**
+ * @brief Evaluates the value of the variable definition once
+ *        and stores it in its global.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return value Returns the value of the node.
+ */
+value_T runtime_visit_var_def(runtime_T* runtime, AST_T* node);
+
+/**
+ * @brief Binds the function definition to its global, invalidating
+ *        the call site caches when it replaces another definition.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return value Returns the value of the node.
+ */
+value_T runtime_visit_fn_def(runtime_T* runtime, AST_T* node);
+
+/**
+ * @brief Reads the variable from its argument slot in the active
+ *        call or from its global.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit(runtime_T* runtime, AST_T* node);
+value_T runtime_visit_var(runtime_T* runtime, AST_T* node);
 
 /**
- * @brief Adds the variable definition to global scope
+ * @brief Evaluates the arguments of the call, binds them to the slots
+ *        of a new frame and visits the function body in that frame.
+ *        The frame and its slots are released when the body returns.
+ *        A call in tail position of the body takes over the frame
+ *        instead of nesting another one. The checked definition is
+ *        cached at the call site until a function is redefined.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_var_def(runtime_T* runtime, AST_T* node);
+value_T runtime_visit_fn_call(runtime_T* runtime, AST_T* node);
 
 /**
- * @brief Adds the function definition to global scope
+ * @brief Evaluates the arguments of the call and passes their values
+ *        to the builtin the call is bound to.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_fn_def(runtime_T* runtime, AST_T* node);
+value_T runtime_call_builtin(runtime_T* runtime, AST_T* node);
 
 /**
- * @brief Adds the variable name to global scope
+ * @brief Gives the interned string of the string literal.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_var(runtime_T* runtime, AST_T* node);
+value_T runtime_visit_string(runtime_T* runtime, AST_T* node);
 
 /**
- * @brief Adds the function name to global scope
+ * @brief Applies the operator to the values of both operands.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_fn_call(runtime_T* runtime, AST_T* node);
+value_T runtime_visit_binary(runtime_T* runtime, AST_T* node);
 
 /**
- * @brief Gives abstract syntax tree on of type String.
+ * @brief Negates the value of the operand.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_string(runtime_T* runtime, AST_T* node);
+value_T runtime_visit_negate(runtime_T* runtime, AST_T* node);
 
 /**
- * @brief Gives abstract syntax tree on of type Compound.
+ * @brief Visits every statement of the compound, which has no
+ *        value of its own.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_compound(runtime_T* runtime, AST_T* node);
+value_T runtime_visit_compound(runtime_T* runtime, AST_T* node);
 #endif
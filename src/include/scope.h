@@ -2,26 +2,41 @@
 #define SCOPE_H
 #include "AST.h"
 
+typedef struct SCOPE_ENTRY_STRUCT
+{
+    const char* name;
+    AST_T* def;
+} scope_entry_T;
+
+/* Open addressing map from interned names to definitions,
+   the capacity is a power of two. */
+typedef struct SCOPE_TABLE_STRUCT
+{
+    scope_entry_T* entries;
+    size_t size;
+    size_t capacity;
+} scope_table_T;
+
 typedef struct SCOPE_STRUCT
 {
-    AST_T** fn_defs;
-    size_t fn_defs_size;
+    arena_T* arena;
 
-    AST_T** var_defs;
-    size_t var_defs_size;
+    scope_table_T fn_defs;
+    scope_table_T var_defs;
 } scope_T;
 
 /**
  * @brief Initializes and allocates the scope struct 
  *        by setting the values to either NULL or 0.
  * 
- * @param[in] NONE
+ * @param[in] arena Pointer to the arena the scope is allocated from.
  * @return scope Returns newly allocated scope.
  */
-scope_T* init_scope();
+scope_T* init_scope(arena_T* arena);
 
 /**
- * @brief Adds a function definition to global scope.
+ * @brief Adds a function definition to global scope. A later
+ *        definition with the same name replaces the earlier one.
  * 
  * @param[in] scope Pointer to the scope struct.
  * @param[in] fdef Pointer to node for current function definition.
@@ -34,14 +49,15 @@ AST_T* scope_add_fn_def(scope_T* scope, AST_T* fdef);
  *        global scope by name.
  * 
  * @param[in] scope Pointer to the scope struct.
- * @param[in] fname String of function name.
+ * @param[in] fname Interned string of function name.
  * @return fdef Returns function definition node if found 
  *         in global scope or NULL if not found.
  */
 AST_T* scope_get_fn_def(scope_T* scope, const char* fname);
 
 /**
- * @brief Adds a variable definition to global scope.
+ * @brief Adds a variable definition to global scope. A later
+ *        definition with the same name replaces the earlier one.
  * 
  * @param[in] scope Pointer to the scope struct.
  * @param[in] vdef Pointer to node for current variable definition.
@@ -54,7 +70,7 @@ AST_T* scope_add_var_def(scope_T* scope, AST_T* vdef);
  *        global scope by name.
  * 
  * @param[in] scope Pointer to the scope struct.
- * @param[in] name String of variable name.
+ * @param[in] name Interned string of variable name.
  * @return vdef Returns variable definition node if found 
  *         in global scope or NULL if not found.
  */
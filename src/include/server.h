@@ -0,0 +1,50 @@
+#ifndef SERVER_H
+#define SERVER_H
+#include <stdint.h>
+#include "io.h"
+
+/* Most bytes a request may carry. */
+#define SERVER_MAX_REQUEST (64u << 20)
+
+/**
+ * Client and server exchange frames of a one byte type, a 32-bit
+ * length in the byte order of the host and the payload. A request is
+ * one frame of the path or the source of a program. The response is
+ * what the program writes, in the order it is written, followed by
+ * one exit frame whose payload is the 32-bit exit status.
+ */
+typedef enum {
+    SERVER_PATH = 'P',
+    SERVER_SOURCE = 'S',
+    SERVER_STDOUT = 'O',
+    SERVER_STDERR = 'E',
+    SERVER_EXIT = 'X',
+} server_frame_T;
+
+/**
+ * @brief Serves programs sent over a Unix socket. Every connection is
+ *        handled by a copy of the process as it was started, with any
+ *        image already restored, and the program runs in a copy of
+ *        that, so no state is left over from earlier requests. The
+ *        server only returns in the copies that run a program, with
+ *        their output going to the client.
+ *
+ * @param[in] path Path of the socket.
+ * @param[out] filename Path of the program, or NULL when its source
+ *             was sent.
+ * @return source Returns the source of the program when it was sent,
+ *         NULL when the program is to be read from its path.
+ */
+source_T* server_serve(const char* path, const char** filename);
+
+/**
+ * @brief Sends a program to a server and writes what it prints to
+ *        the standard output and error.
+ *
+ * @param[in] path Path of the socket.
+ * @param[in] filename Path of the program, or "-" to send the source
+ *            read from the standard input.
+ * @return status Returns the exit status of the program.
+ */
+int server_connect(const char* path, const char* filename);
+#endif
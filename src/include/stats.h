@@ -0,0 +1,135 @@
+#ifndef STATS_H
+#define STATS_H
+#include "AST.h"
+#include "arena.h"
+#include "lexer.h"
+#include "scope.h"
+#include "runtime.h"
+
+/* Phases of a run, in the order they run. The parser drives the
+   lexer, so the parse phase includes lexing unless only the tokens
+   are scanned. Loading and storing the compiled program both count
+   as the cache phase, loading and dumping an image as the image phase. */
+typedef enum {
+    STATS_IMAGE,
+    STATS_READ,
+    STATS_CACHE,
+    STATS_LEX,
+    STATS_PARSE,
+    STATS_RESOLVE,
+    STATS_FOLD,
+    STATS_COMPILE,
+    STATS_RUN,
+    STATS_PHASES
+} stats_phase_T;
+
+typedef enum {
+    STATS_TEXT,
+    STATS_JSON
+} stats_format_T;
+
+/* Time a phase took and what it allocated from the arena. */
+typedef struct STATS_PHASE_STRUCT
+{
+    int ran;
+    double wall;
+    double cpu;
+    size_t allocations;
+    size_t allocated;
+} stats_phase_result_T;
+
+typedef struct STATS_STRUCT
+{
+    stats_format_T format;
+    arena_T* arena;
+
+    /* Phase that runs and where it started. */
+    stats_phase_T phase;
+    stats_phase_result_T start;
+    stats_phase_result_T phases[STATS_PHASES];
+
+    size_t tokens;
+    size_t nodes[AST_TYPES];
+    size_t scope_functions;
+    size_t scope_variables;
+    size_t globals;
+    size_t functions;
+    size_t builtins;
+} stats_T;
+
+/**
+ * @brief Initializes and allocates the statistics of a run. Every
+ *        other stats function does nothing when given NULL instead,
+ *        so that a run without statistics pays nothing for them.
+ *
+ * @param[in] arena Pointer to the arena the phases allocate from.
+ * @param[in] format Format the statistics are printed in.
+ * @return stats Returns newly allocated statistics.
+ */
+stats_T* init_stats(arena_T* arena, stats_format_T format);
+
+/**
+ * @brief Releases the statistics.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @return void Does not return.
+ */
+void stats_free(stats_T* stats);
+
+/**
+ * @brief Starts timing a phase.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @param[in] phase Phase that starts.
+ * @return void Does not return.
+ */
+void stats_begin(stats_T* stats, stats_phase_T phase);
+
+/**
+ * @brief Stops timing the phase that runs and adds its time and
+ *        allocations to those of the phase.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @return void Does not return.
+ */
+void stats_end(stats_T* stats);
+
+/**
+ * @brief Counts the nodes of every type below a node.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void stats_count_nodes(stats_T* stats, AST_T* node);
+
+/**
+ * @brief Records the tokens of the lexer, the definitions of the
+ *        scope and the globals, functions and builtins of the runtime.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @param[in] lexer Pointer to the lexer struct.
+ * @param[in] scope Pointer to the parsed scope, or NULL if nothing
+ *            was parsed.
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void stats_record(stats_T* stats, lexer_T* lexer, scope_T* scope, runtime_T* runtime);
+
+/**
+ * @brief Gives the most memory the process has had resident.
+ *
+ * @param[in] NONE
+ * @return size Returns the peak resident set size in kilobytes.
+ */
+long stats_peak_rss();
+
+/**
+ * @brief Prints the statistics to stderr, so that they do not mix
+ *        with what the program prints.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @return void Does not return.
+ */
+void stats_print(stats_T* stats);
+#endif
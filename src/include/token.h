@@ -1,5 +1,7 @@
 #ifndef TOKEN_H
 #define TOKEN_H
+#include "arena.h"
+
 typedef struct TOKEN_STRUCT
 {
     enum {
@@ -33,23 +35,33 @@ typedef struct TOKEN_STRUCT
         TOKEN_PERCENTAGE,
         TOKEN_DOT,
         TOKEN_LESS_THAN,
+        TOKEN_LESS_THAN_EQUALS,
         TOKEN_LARGER_THAN,
+        TOKEN_LARGER_THAN_EQUALS,
         TOKEN_AND,
         TOKEN_QUESTION,
         TOKEN_COLON,
         TOKEN_EOF,
     } type;
 
-    char* value;
+    /* Span of the token in the lexer contents, no copy is made. */
+    size_t start;
+    size_t length;
+
+    /* Interned value of ID and String tokens, NULL otherwise. */
+    const char* value;
 } token_T;
 
 /**
  * @brief Initializes and allocates new token.
- *        Sets the type and value to the provided parameters 
+ *        Sets the type and the span in the lexer contents
+ *        to the provided parameters.
  * 
+ * @param[in] arena Pointer to the arena the token is allocated from.
  * @param[in] type Integer value of the type.
- * @param[in] value String of the value.
+ * @param[in] start Offset of the first character of the value.
+ * @param[in] length Amount of characters in the value.
  * @return token Returns newly allocated token.
  */
-token_T* init_token(int type, char* value);
+token_T* init_token(arena_T* arena, int type, size_t start, size_t length);
 #endif
@@ -0,0 +1,155 @@
+#ifndef VALUE_H
+#define VALUE_H
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Runtime values are NaN-boxed into 64 bits. A double is stored as is,
+ * every other value is a quiet NaN with the tag in bits 48 to 49 and
+ * the sign bit set for pointers:
+ *
+ *   undefined   0x7ffc 0000 0000 0000
+ *   nil         0x7ffd 0000 0000 0000
+ *   bool        0x7ffe 0000 0000 000b
+ *   int32       0x7fff 0000 iiii iiii
+ *   string      0xfffd pppp pppp pppp   interned, NUL terminated
+ *   function    0xfffe pppp pppp pppp
+ *
+ * NaN results of arithmetic are canonical, so they never collide with
+ * a tag. Undefined only marks globals whose definition has not run.
+ */
+typedef uint64_t value_T;
+
+#define VALUE_QNAN          0x7ffc000000000000ull
+#define VALUE_SIGN          0x8000000000000000ull
+#define VALUE_TAG_MASK      0xffff000000000000ull
+#define VALUE_PAYLOAD_MASK  0x0000ffffffffffffull
+
+#define VALUE_TAG_UNDEFINED (VALUE_QNAN)
+#define VALUE_TAG_NIL       (VALUE_QNAN | 0x0001000000000000ull)
+#define VALUE_TAG_BOOL      (VALUE_QNAN | 0x0002000000000000ull)
+#define VALUE_TAG_INT       (VALUE_QNAN | 0x0003000000000000ull)
+#define VALUE_TAG_STRING    (VALUE_SIGN | VALUE_QNAN | 0x0001000000000000ull)
+#define VALUE_TAG_FUNCTION  (VALUE_SIGN | VALUE_QNAN | 0x0002000000000000ull)
+
+#define VALUE_UNDEFINED     VALUE_TAG_UNDEFINED
+#define VALUE_NIL           VALUE_TAG_NIL
+#define VALUE_FALSE         (VALUE_TAG_BOOL | 0)
+#define VALUE_TRUE          (VALUE_TAG_BOOL | 1)
+
+static inline int value_is_double(value_T value) {
+    return (value & VALUE_QNAN) != VALUE_QNAN;
+}
+
+static inline int value_is_int(value_T value) {
+    return (value & VALUE_TAG_MASK) == VALUE_TAG_INT;
+}
+
+static inline int value_is_bool(value_T value) {
+    return (value & VALUE_TAG_MASK) == VALUE_TAG_BOOL;
+}
+
+static inline int value_is_string(value_T value) {
+    return (value & VALUE_TAG_MASK) == VALUE_TAG_STRING;
+}
+
+static inline int value_is_function(value_T value) {
+    return (value & VALUE_TAG_MASK) == VALUE_TAG_FUNCTION;
+}
+
+static inline value_T value_double(double number) {
+    value_T value;
+
+    // Arithmetic may produce NaNs with any payload.
+    if (number != number) {
+        return 0x7ff8000000000000ull;
+    }
+
+    memcpy(&value, &number, sizeof(value));
+
+    return value;
+}
+
+static inline double value_as_double(value_T value) {
+    double number;
+    memcpy(&number, &value, sizeof(number));
+
+    return number;
+}
+
+static inline value_T value_int(int32_t number) {
+    return VALUE_TAG_INT | (uint32_t) number;
+}
+
+static inline int32_t value_as_int(value_T value) {
+    return (int32_t) (uint32_t) value;
+}
+
+static inline value_T value_bool(int boolean) {
+    return boolean ? VALUE_TRUE : VALUE_FALSE;
+}
+
+static inline value_T value_string(const char* string) {
+    return VALUE_TAG_STRING | (uintptr_t) string;
+}
+
+static inline const char* value_as_string(value_T value) {
+    return (const char*) (uintptr_t) (value & VALUE_PAYLOAD_MASK);
+}
+
+static inline value_T value_function(const void* function) {
+    return VALUE_TAG_FUNCTION | (uintptr_t) function;
+}
+
+static inline const void* value_as_function(value_T value) {
+    return (const void*) (uintptr_t) (value & VALUE_PAYLOAD_MASK);
+}
+
+/* Binary operators, in the order of their opcodes. */
+typedef enum {
+    VALUE_OP_ADD,
+    VALUE_OP_SUB,
+    VALUE_OP_MUL,
+    VALUE_OP_DIV,
+    VALUE_OP_MOD,
+    VALUE_OP_EQUAL,
+    VALUE_OP_NOT_EQUAL,
+    VALUE_OP_LESS,
+    VALUE_OP_GREATER,
+    VALUE_OP_LESS_EQUAL,
+    VALUE_OP_GREATER_EQUAL,
+} value_op_T;
+
+/* Outcome of an operation on values. */
+typedef enum {
+    VALUE_OK,
+    VALUE_ERROR_TYPES,
+    VALUE_ERROR_DIVISION_BY_ZERO,
+} value_status_T;
+
+/* Source text of each binary operator. */
+extern const char* const value_op_names[];
+
+/**
+ * @brief Applies a binary operator. Integers stay integers unless the
+ *        result does not fit or a division is not exact, mixed operands
+ *        are computed as doubles. Every value can be compared for
+ *        equality, only numbers can be ordered.
+ * 
+ * @param[in] op Operator to apply.
+ * @param[in] left Left operand.
+ * @param[in] right Right operand.
+ * @param[out] result Result of the operation, when it succeeds.
+ * @return status Returns VALUE_OK or why the operation failed.
+ */
+value_status_T value_binary(value_op_T op, value_T left, value_T right, value_T* result);
+
+/**
+ * @brief Negates a number.
+ * 
+ * @param[in] value Operand.
+ * @param[out] result Negated number, when the operand is a number.
+ * @return status Returns VALUE_OK or why the operation failed.
+ */
+value_status_T value_negate(value_T value, value_T* result);
+#endif
@@ -0,0 +1,66 @@
+#ifndef VM_H
+#define VM_H
+#include "AST.h"
+#include "chunk.h"
+#include "runtime.h"
+
+/* Active call of a compiled function. Its arguments are the
+   values of the stack from base up to the arity of the function. */
+typedef struct VM_FRAME_STRUCT
+{
+    chunk_function_T* function;
+    const uint8_t* ip;
+    size_t base;
+} vm_frame_T;
+
+typedef struct VM_STRUCT
+{
+    runtime_T* runtime;
+
+    value_T* stack;
+    size_t stack_size;
+    size_t stack_capacity;
+
+    /* Active calls, innermost last. */
+    vm_frame_T* frames;
+    size_t frames_size;
+    size_t frames_capacity;
+
+    /* Values of the variable globals and functions bound to the
+       function globals of the runtime, undefined until defined. */
+    value_T* globals;
+    size_t globals_size;
+    chunk_function_T** functions;
+    size_t functions_size;
+
+    /* Changes whenever a defined function is replaced, which
+       invalidates the cache of every call site. */
+    size_t functions_version;
+} vm_T;
+
+/**
+ * @brief Initializes and allocates the virtual machine.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return vm Returns newly allocated virtual machine.
+ */
+vm_T* init_vm(runtime_T* runtime);
+
+/**
+ * @brief Releases the stacks and globals of the virtual machine.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @return void Does not return.
+ */
+void vm_free(vm_T* vm);
+
+/**
+ * @brief Runs the top level of a compiled program. Globals defined
+ *        by earlier runs stay defined.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @param[in] chunk Pointer to the compiled program.
+ * @return value Returns the value of the program.
+ */
+value_T vm_run(vm_T* vm, chunk_T* chunk);
+#endif
@@ -0,0 +1,116 @@
+#include "include/intern.h"
+#include <string.h>
+
+#define INTERNER_CAPACITY 1024
+
+/**
+ * @brief Initializes and allocates an interner, a set of unique
+ *        strings. Interning the same characters twice returns the
+ *        same pointer, so interned strings compare by pointer.
+ * 
+ * @param[in] arena Pointer to the arena the interner and strings live in.
+ * @return interner Returns newly allocated interner.
+ */
+interner_T* init_interner(arena_T* arena) {
+    interner_T* interner = arena_alloc(arena, sizeof(struct INTERNER_STRUCT));
+    interner->arena = arena;
+    interner->size = 0;
+    interner->capacity = INTERNER_CAPACITY;
+    interner->entries = arena_alloc(
+        arena,
+        interner->capacity * sizeof(struct INTERN_ENTRY_STRUCT)
+    );
+
+    return interner;
+}
+
+/**
+ * @brief Hashes a string of a given length.
+ * 
+ * @param[in] str String to hash.
+ * @param[in] length Amount of characters in the string.
+ * @return hash Returns the 64-bit FNV-1a hash of the string.
+ */
+uint64_t intern_hash(const char* str, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) str[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Doubles the capacity of the table and reinserts every entry.
+ * 
+ * @param[in] interner Pointer to the interner struct.
+ * @return void Does not return.
+ */
+static void interner_grow(interner_T* interner) {
+    intern_entry_T* entries = interner->entries;
+    size_t capacity = interner->capacity;
+
+    interner->capacity *= 2;
+    interner->entries = arena_alloc(
+        interner->arena,
+        interner->capacity * sizeof(struct INTERN_ENTRY_STRUCT)
+    );
+
+    for (size_t i = 0; i < capacity; i++) {
+        if (entries[i].str == NULL) {
+            continue;
+        }
+
+        size_t j = entries[i].hash & (interner->capacity - 1);
+
+        while (interner->entries[j].str != NULL) {
+            j = (j + 1) & (interner->capacity - 1);
+        }
+
+        interner->entries[j] = entries[i];
+    }
+}
+
+/**
+ * @brief Returns the unique copy of a string, copying it into
+ *        the arena the first time it is seen.
+ * 
+ * @param[in] interner Pointer to the interner struct.
+ * @param[in] str String to intern, it does not need to be NUL-terminated.
+ * @param[in] length Amount of characters in the string.
+ * @return str Returns the interned, NUL-terminated string.
+ */
+const char* interner_intern(interner_T* interner, const char* str, size_t length) {
+    uint64_t hash = intern_hash(str, length);
+    size_t i = hash & (interner->capacity - 1);
+
+    while (interner->entries[i].str != NULL) {
+        intern_entry_T* entry = &interner->entries[i];
+
+        if (entry->hash == hash
+            && entry->length == length
+            && memcmp(entry->str, str, length) == 0) {
+            return entry->str;
+        }
+
+        i = (i + 1) & (interner->capacity - 1);
+    }
+
+    intern_entry_T* entry = &interner->entries[i];
+    entry->str = arena_strndup(interner->arena, str, length);
+    entry->length = length;
+    entry->hash = hash;
+    interner->size += 1;
+
+    // Keep the table at most half full so probe sequences stay short.
+    if (interner->size * 2 > interner->capacity) {
+        const char* interned = entry->str;
+        interner_grow(interner);
+
+        return interned;
+    }
+
+    return entry->str;
+}
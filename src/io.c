@@ -1,35 +1,289 @@
 #include "include/io.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 
 /**
- * @brief Reads and returns blink source file.
+ * @brief Reads a file completely, NUL-terminated.
  * 
- * @param[in] filepath String of path to source file.
- * @return buffer Returns read characters of blink 
- *         source file. Otherwise, the program will print an error and exit.
+ * @param[in] filepath String of path to the file.
+ * @param[out] length Amount of characters read.
+ * @param[in] error Where a failed read is reported, or NULL to exit.
+ * @return buffer Returns the newly allocated characters.
  */
-char* get_file_contents(const char* filepath) {
-    char* buffer = 0;
-    long length;
-
+static char* read_file_contents(const char* filepath, size_t* length, error_T* error) {
     FILE* f = fopen(filepath, "rb");
 
     if (f)
     {
-        fseek(f, 0, SEEK_END);
-        length = ftell(f);
-        fseek(f, 0, SEEK_SET);
+        size_t capacity = 4096;
+        size_t size = 0;
+        char* buffer = malloc(capacity);
+
+        // The size is not known up front for pipes, so grow as we go.
+        while (buffer) {
+            size += fread(buffer + size, 1, capacity - size - 1, f);
+
+            if (size < capacity - 1)
+                break;
 
-        buffer = calloc(length, length);
+            capacity *= 2;
+            buffer = realloc(buffer, capacity);
+        }
 
-        if (buffer)
-            fread(buffer, 1, length, f);
+        if (buffer == NULL || ferror(f)) {
+            free(buffer);
+            fclose(f);
+            error_report(error, "Error reading file %s", filepath);
+            error_raise(error, 2);
+        }
 
         fclose(f);
+        buffer[size] = '\0';
+        *length = size;
         return buffer;
     }
 
-    printf("Error reading file %s\n", filepath);
-    exit(2);
+    error_report(error, "Error reading file %s", filepath);
+    error_raise(error, 2);
+}
+
+/**
+ * @brief Loads a blink source file like get_file_source, reporting a
+ *        file that cannot be loaded as an error.
+ * 
+ * @param[in] filepath String of path to source file.
+ * @param[in] error Where a failed load is reported, or NULL to exit.
+ * @return source Returns newly allocated source.
+ */
+source_T* read_file_source(const char* filepath, error_T* error) {
+    struct stat st;
+    int fd = open(filepath, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+
+        error_report(error, "Error reading file %s", filepath);
+        error_raise(error, 2);
+    }
+
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        size_t length;
+        char* contents = read_file_contents(filepath, &length, error);
+        source_T* source = calloc(1, sizeof(struct SOURCE_STRUCT));
+        source->contents = contents;
+        source->length = length;
+
+        return source;
+    }
+
+    if ((uintmax_t) st.st_size > SIZE_MAX) {
+        close(fd);
+        error_report(error, "File %s is too large to map", filepath);
+        error_raise(error, 2);
+    }
+
+    void* contents = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (contents == MAP_FAILED) {
+        error_report(error, "Error mapping file %s", filepath);
+        error_raise(error, 2);
+    }
+
+    madvise(contents, st.st_size, MADV_SEQUENTIAL);
+
+    source_T* source = calloc(1, sizeof(struct SOURCE_STRUCT));
+    source->contents = contents;
+    source->length = st.st_size;
+    source->is_mapped = 1;
+
+    return source;
+}
+
+/**
+ * @brief Loads a blink source file. Regular files are memory-mapped
+ *        read-only with a sequential access hint, so the contents are
+ *        never copied and their pages are shared between every process
+ *        running the same file. Anything else, such as a pipe, is read
+ *        with get_file_contents. The contents are not NUL-terminated.
+ * 
+ * @param[in] filepath String of path to source file.
+ * @return source Returns newly allocated source. Otherwise, the 
+ *         program will print an error and exit.
+ */
+source_T* get_file_source(const char* filepath) {
+    return read_file_source(filepath, NULL);
+}
+
+/**
+ * @brief Unmaps or frees the contents of a source and the source itself.
+ * 
+ * @param[in] source Pointer to the source struct.
+ * @return void Does not return.
+ */
+void source_free(source_T* source) {
+    if (source->is_mapped) {
+        munmap((void*) source->contents, source->length);
+    } else {
+        free((void*) source->contents);
+    }
+
+    free(source);
+}
+
+/**
+ * @brief Reads and returns blink source file.
+ * 
+ * @param[in] filepath String of path to source file.
+ * @param[out] length Amount of characters read.
+ * @return buffer Returns read characters of blink 
+ *         source file, NUL-terminated. Otherwise, the program will
+ *         print an error and exit.
+ */
+char* get_file_contents(const char* filepath, size_t* length) {
+    return read_file_contents(filepath, length, NULL);
+}
+
+/**
+ * @brief Initializes and allocates a buffered output to a file
+ *        descriptor. Terminals are flushed line by line, anything
+ *        else block by block.
+ * 
+ * @param[in] fd File descriptor to write to.
+ * @return out Returns newly allocated output.
+ */
+out_T* init_out(int fd) {
+    out_T* out = calloc(1, sizeof(struct OUT_STRUCT));
+    out->fd = fd;
+    out->capacity = OUT_BUFFER_SIZE;
+    out->buffer = malloc(out->capacity);
+    out->policy = isatty(fd) ? OUT_FLUSH_LINE : OUT_FLUSH_BLOCK;
+
+    return out;
+}
+
+/**
+ * @brief Flushes the output, then sets its buffer size and flush policy.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @param[in] capacity Size of the buffer in bytes, at least 1.
+ * @param[in] policy When the buffer is written.
+ * @return void Does not return.
+ */
+void out_configure(out_T* out, size_t capacity, out_flush_T policy) {
+    out_flush(out);
+
+    out->capacity = capacity;
+    out->buffer = realloc(out->buffer, capacity);
+    out->policy = policy;
+}
+
+/**
+ * @brief Writes every byte of the vectors, retrying partial writes.
+ *        Output that cannot be written is dropped.
+ * 
+ * @param[in] fd File descriptor to write to.
+ * @param[in] iov Vectors of bytes to write, they are used up.
+ * @param[in] iovcnt Amount of vectors.
+ * @return void Does not return.
+ */
+static void out_write_vectors(int fd, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t written = writev(fd, iov, iovcnt);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return;
+        }
+
+        while (iovcnt > 0 && (size_t) written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+
+        if (iovcnt > 0) {
+            iov->iov_base = (char*) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+/**
+ * @brief Copies bytes into the output buffer. Writes that do not fit
+ *        the buffer go out together with it in a single writev.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @param[in] data Bytes to write.
+ * @param[in] length Amount of bytes to write.
+ * @return void Does not return.
+ */
+void out_write(out_T* out, const char* data, size_t length) {
+    if (out->size + length > out->capacity) {
+        if (out->policy != OUT_FLUSH_EXPLICIT) {
+            struct iovec iov[2] = {
+                { out->buffer, out->size },
+                { (void*) data, length },
+            };
+            out_write_vectors(out->fd, iov, 2);
+            out->size = 0;
+
+            return;
+        }
+
+        while (out->size + length > out->capacity) {
+            out->capacity *= 2;
+        }
+
+        out->buffer = realloc(out->buffer, out->capacity);
+    }
+
+    memcpy(out->buffer + out->size, data, length);
+    out->size += length;
+
+    if (out->policy == OUT_FLUSH_LINE && memchr(data, '\n', length) != NULL) {
+        out_flush(out);
+    }
+}
+
+/**
+ * @brief Writes everything that is buffered.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @return void Does not return.
+ */
+void out_flush(out_T* out) {
+    if (out->size == 0) {
+        return;
+    }
+
+    struct iovec iov = { out->buffer, out->size };
+    out_write_vectors(out->fd, &iov, 1);
+    out->size = 0;
+}
+
+/**
+ * @brief Flushes and frees the output.
+ * 
+ * @param[in] out Pointer to the output struct.
+ * @return void Does not return.
+ */
+void out_free(out_T* out) {
+    out_flush(out);
+    free(out->buffer);
+    free(out);
 }
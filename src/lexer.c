@@ -5,22 +5,53 @@
 #include <stdio.h>
 
 
+/**
+ * @brief Reuses a released token or allocates a new one.
+ * 
+ * @param[in] lexer Pointer to lexer struct
+ * @param[in] type Integer value of the type.
+ * @param[in] start Offset of the first character of the value.
+ * @param[in] length Amount of characters in the value.
+ * @return token Returns the token.
+ */
+static token_T* lexer_make_token(lexer_T* lexer, int type, size_t start, size_t length) {
+    lexer->tokens++;
+
+    if (lexer->free_tokens_size == 0) {
+        return init_token(lexer->arena, type, start, length);
+    }
+
+    token_T* token = lexer->free_tokens[--lexer->free_tokens_size];
+    token->type = type;
+    token->start = start;
+    token->length = length;
+    token->value = NULL;
+
+    return token;
+}
+
 /**
  * @brief Initializes lexer and allocates memory for string of  
  *        characters from the contents of the input file.
  *        During initialization, the contents are set to the 
  *        contents of the input file, the character index is set 
  *        to 0, and the current character is set to the first character 
- *        of the contents.
+ *        of the contents. The contents do not need to be NUL-terminated,
+ *        the lexer never reads past the given length.
  * 
  * @param[in] contents String of character from the input file
+ * @param[in] length Amount of characters in the contents
+ * @param[in] arena Pointer to the arena the lexer and tokens live in
+ * @param[in] interner Pointer to the interner identifiers and strings go to
  * @return lexer Newly allocated lexer struct
  */
-lexer_T *init_lexer(char* contents) {
-    lexer_T *lexer = calloc(1, sizeof(struct LEXER_STRUCT));
+lexer_T *init_lexer(const char* contents, size_t length, arena_T* arena, interner_T* interner) {
+    lexer_T *lexer = arena_alloc(arena, sizeof(struct LEXER_STRUCT));
+    lexer->arena = arena;
+    lexer->interner = interner;
     lexer->contents = contents;
-    lexer->i = 0;
-    lexer->c = contents[lexer->i];
+    lexer->length = length;
+    lexer_seek(lexer, 0);
 
     return lexer;
 }
@@ -35,12 +66,24 @@ lexer_T *init_lexer(char* contents) {
  * @return void Does not return.
  */
 void lexer_advance(lexer_T* lexer) {
-    if (lexer->c != '\0' && lexer->i < strlen(lexer->contents)) {
-        lexer->i += 1;
-        lexer->c = lexer->contents[lexer->i];
+    if (lexer->i < lexer->length) {
+        lexer_seek(lexer, lexer->i + 1);
     }
 }
 
+/**
+ * @brief Moves the lexer to an absolute position in the contents
+ *        and updates the current character.
+ * 
+ * @param[in] lexer Pointer to lexer struct
+ * @param[in] i Index to move to, at most the length of the contents.
+ * @return void Does not return.
+ */
+void lexer_seek(lexer_T* lexer, size_t i) {
+    lexer->i = i;
+    lexer->c = i < lexer->length ? lexer->contents[i] : '\0';
+}
+
 /**
  * @brief Inspects each character and skips whitespace and newlines. 
  *        If either are encountered then the function lexer_advance 
@@ -50,122 +93,240 @@ void lexer_advance(lexer_T* lexer) {
  * @return void Does not return.
  */
 void lexer_skip_whitespace(lexer_T* lexer) {
-    while (lexer->c == ' ' || lexer->c == '\n') {
-        lexer_advance(lexer);
+    const char* p = lexer->contents + lexer->i;
+    const char* end = lexer->contents + lexer->length;
+
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r')) {
+        p++;
     }
+
+    lexer_seek(lexer, p - lexer->contents);
 }
 
 /**
- * @brief Inspects each character and skips whitespace and newlines. 
- *        If either are encountered then the function lexer_advance 
- *        is called and the pointer is incremented to the next character.
+ * @brief Skips whitespace and scans the next token from the contents.
+ *        Exits with an error on characters that do not start a token.
  * 
  * @param[in] lexer Pointer to lexer struct
- * @return void Does not return.
+ * @return token Returns the next token, or an EOF token at the end.
  */
 token_T *lexer_get_next_token(lexer_T* lexer) {
-    while (lexer->c != '\0' && lexer->i < strlen(lexer->contents)) {
-        if (lexer->c == ' ' || lexer->c == 10) {
-            lexer_skip_whitespace(lexer);
-        }
+    lexer_skip_whitespace(lexer);
 
-        if (isalnum(lexer->c)) {
-            return lexer_collect_id(lexer);
-        }
+    if (lexer->i >= lexer->length) {
+        return lexer_make_token(lexer, TOKEN_EOF, lexer->length, 0);
+    }
+
+    if (isdigit((unsigned char) lexer->c)) {
+        return lexer_collect_number(lexer);
+    }
+
+    if (isalnum((unsigned char) lexer->c)) {
+        return lexer_collect_id(lexer);
+    }
 
-        if (lexer->c == '"') {
+    switch (lexer->c) {
+        case '"': {
             return lexer_collect_string(lexer);
         }
-
-        switch (lexer->c) {
-            case '=': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_EQUALS, lexer_get_current_char_as_string(lexer)));
-            }
-            case ';': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_SEMI, lexer_get_current_char_as_string(lexer)));
-            }
-            case '(': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_LPAREN, lexer_get_current_char_as_string(lexer)));
-            }
-            case ')': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_RPAREN, lexer_get_current_char_as_string(lexer)));
-            }
-            case '{': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_LBRACE, lexer_get_current_char_as_string(lexer)));
-            }
-            case '}': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_RBRACE, lexer_get_current_char_as_string(lexer)));
-            }
-            case ',': {
-                return lexer_advance_with_token(
-                    lexer, 
-                    init_token(TOKEN_COMMA, lexer_get_current_char_as_string(lexer)));
-            }
+        case '=': {
+            return lexer_collect_operator(lexer, TOKEN_EQUALS, TOKEN_EQUALS_EQUALS);
+        }
+        case '!': {
+            return lexer_collect_operator(lexer, TOKEN_NOT, TOKEN_NOT_EQUALS);
+        }
+        case '<': {
+            return lexer_collect_operator(lexer, TOKEN_LESS_THAN, TOKEN_LESS_THAN_EQUALS);
+        }
+        case '>': {
+            return lexer_collect_operator(lexer, TOKEN_LARGER_THAN, TOKEN_LARGER_THAN_EQUALS);
+        }
+        case '+': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_PLUS, lexer->i, 1));
+        }
+        case '-': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_MINUS, lexer->i, 1));
+        }
+        case '*': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_STAR, lexer->i, 1));
+        }
+        case '/': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_DIV, lexer->i, 1));
+        }
+        case '%': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_PERCENTAGE, lexer->i, 1));
+        }
+        case ';': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_SEMI, lexer->i, 1));
+        }
+        case '(': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_LPAREN, lexer->i, 1));
+        }
+        case ')': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_RPAREN, lexer->i, 1));
+        }
+        case '{': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_LBRACE, lexer->i, 1));
+        }
+        case '}': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_RBRACE, lexer->i, 1));
+        }
+        case ',': {
+            return lexer_advance_with_token(
+                lexer, 
+                lexer_make_token(lexer, TOKEN_COMMA, lexer->i, 1));
         }
     }
 
-    return init_token(TOKEN_EOF, "\0");
+    error_report(lexer->error, "Unexpected character `%c`", lexer->c);
+    error_raise(lexer->error, 1);
 }
 
 
 /**
- * @brief Inspects each character and adds it to the string as long as
- *        it does not encounter another quote ( " ).
+ * @brief Finds the closing quote ( " ) and spans and interns
+ *        everything between the quotes.
  * 
  * @param[in] lexer Pointer to lexer struct
  * @return token Returns a String token.
  */
 token_T* lexer_collect_string(lexer_T* lexer) {
-    lexer_advance(lexer);
+    size_t start = lexer->i + 1;
+    const char* end = memchr(
+        lexer->contents + start,
+        '"',
+        lexer->length - start
+    );
+
+    if (end == NULL) {
+        error_report(lexer->error, "Unterminated string literal");
+        error_raise(lexer->error, 1);
+    }
+
+    size_t length = end - (lexer->contents + start);
+    token_T* token = lexer_make_token(lexer, TOKEN_STRING_VALUE, start, length);
+    token->value = interner_intern(lexer->interner, lexer->contents + start, length);
+
+    // Skip past the closing quote.
+    lexer_seek(lexer, start + length + 1);
+
+    return token;
+}
 
-    char* value = calloc(1, sizeof(char));
-    value[0] = '\0';
+/**
+ * @brief Scans an operator that is one character on its own,
+ *        or two characters when it is followed by `=`.
+ * 
+ * @param[in] lexer Pointer to lexer struct
+ * @param[in] type Token type of the operator on its own.
+ * @param[in] type_equals Token type of the operator followed by `=`.
+ * @return token Returns the operator token.
+ */
+token_T* lexer_collect_operator(lexer_T* lexer, int type, int type_equals) {
+    size_t start = lexer->i;
 
-    while (lexer->c != '"')  {
-        char* s = lexer_get_current_char_as_string(lexer);
-        value = realloc(value, (strlen(value) + strlen(s) + 1) * sizeof(char));
-        strcat(value, s);
+    if (start + 1 < lexer->length && lexer->contents[start + 1] == '=') {
+        lexer_seek(lexer, start + 2);
 
-        lexer_advance(lexer);
+        return lexer_make_token(lexer, type_equals, start, 2);
     }
 
-    lexer_advance(lexer);
+    lexer_seek(lexer, start + 1);
+
+    return lexer_make_token(lexer, type, start, 1);
+}
+
+/**
+ * @brief Spans the digits of a number. A fraction or an exponent
+ *        makes it a Float, otherwise it is an Integer. The parser
+ *        converts the span to its value.
+ * 
+ * @param[in] lexer Pointer to lexer struct
+ * @return token Returns an Integer or Float token.
+ */
+token_T* lexer_collect_number(lexer_T* lexer) {
+    const char* start = lexer->contents + lexer->i;
+    const char* end = lexer->contents + lexer->length;
+    const char* p = start;
+    int type = TOKEN_INTEGER_VALUE;
+
+    while (p < end && isdigit((unsigned char) *p)) {
+        p++;
+    }
+
+    if (p + 1 < end && *p == '.' && isdigit((unsigned char) p[1])) {
+        type = TOKEN_FLOAT_VALUE;
+        p++;
+
+        while (p < end && isdigit((unsigned char) *p)) {
+            p++;
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* exponent = p + 1;
+
+        if (exponent < end && (*exponent == '+' || *exponent == '-')) {
+            exponent++;
+        }
+
+        if (exponent < end && isdigit((unsigned char) *exponent)) {
+            type = TOKEN_FLOAT_VALUE;
+            p = exponent;
+
+            while (p < end && isdigit((unsigned char) *p)) {
+                p++;
+            }
+        }
+    }
 
-    return init_token(TOKEN_STRING_VALUE, value);
+    token_T* token = lexer_make_token(lexer, type, lexer->i, p - start);
+    lexer_seek(lexer, lexer->i + token->length);
+
+    return token;
 }
 
 /**
- * @brief Inspects each character and adds it to the value
- *        as long as the current character is alphanumeric.
+ * @brief Scans ahead while the characters are alphanumeric
+ *        and spans and interns them.
  * 
  * @param[in] lexer Pointer to lexer struct
  * @return token Returns an ID token.
  */
 token_T *lexer_collect_id(lexer_T *lexer) {
-    char *value = calloc(1, sizeof(char));
-    value[0] = '\0';
-
-    while (isalnum(lexer->c)) {
-        char *s = lexer_get_current_char_as_string(lexer);
-        value = realloc(value, (strlen(value) + strlen(s) + 1) * sizeof(char));
-        strcat(value, s);
+    const char* start = lexer->contents + lexer->i;
+    const char* end = lexer->contents + lexer->length;
+    const char* p = start;
 
-        lexer_advance(lexer);
+    while (p < end && isalnum((unsigned char) *p)) {
+        p++;
     }
 
-    return init_token(TOKEN_ID, value);
+    token_T* token = lexer_make_token(lexer, TOKEN_ID, lexer->i, p - start);
+    token->value = interner_intern(lexer->interner, start, token->length);
+    lexer_seek(lexer, lexer->i + token->length);
+
+    return token;
 }
 
 /**
@@ -182,15 +343,15 @@ token_T *lexer_advance_with_token(lexer_T *lexer, token_T *token) {
 }
 
 /**
- * @brief Allocates memory for current character and returns.
+ * @brief Hands a token that is no longer referenced back to the
+ *        lexer, so that its memory is reused for a later token.
  * 
  * @param[in] lexer Pointer to lexer struct
- * @return str Returns newly allocated String.
+ * @param[in] token Pointer to token struct
+ * @return void Does not return.
  */
-char *lexer_get_current_char_as_string(lexer_T *lexer) {
-    char *str = calloc(2, sizeof(char));
-    str[0] = lexer->c;
-    str[1] = '\0';
-
-    return str;
+void lexer_release_token(lexer_T *lexer, token_T *token) {
+    if (lexer->free_tokens_size < LEXER_FREE_TOKENS) {
+        lexer->free_tokens[lexer->free_tokens_size++] = token;
+    }
 }
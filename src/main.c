@@ -1,8 +1,18 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "include/lexer.h"
 #include "include/parser.h"
 #include "include/runtime.h"
+#include "include/resolver.h"
+#include "include/folder.h"
+#include "include/compiler.h"
+#include "include/vm.h"
 #include "include/io.h"
+#include "include/stats.h"
+#include "include/cache.h"
+#include "include/image.h"
+#include "include/server.h"
 
 /**
  * @brief Print help for running blink interpreter.
@@ -11,22 +21,307 @@
  * @return int Returns 0 on successful run. 
  */
 void print_help() {
-    printf("Usage:\nblink.out <filename>\n");
+    printf(
+        "Usage:\nblink.out [options] <filename>\n"
+        "  --vm                      run on the bytecode virtual machine\n"
+        "  --lex-only                only scan the tokens of the program\n"
+        "  --parse-only              only parse and resolve the program\n"
+        "  --flush <line|block|explicit>\n"
+        "                            when printed output is written\n"
+        "  --output-buffer <bytes>   size of the output buffer\n"
+        "  --max-depth <calls>       most calls that may be nested\n"
+        "  --cache                   reuse the compiled program kept next to the\n"
+        "                            source, implies --vm\n"
+        "  --cache-dir <dir>         keep the compiled programs in a directory\n"
+        "  --dump-image <file>       run the program on the tree-walker and write\n"
+        "                            the globals and functions it leaves to an image\n"
+        "  --image <file>            start from the state of an image\n"
+        "  --serve <socket>          run the programs clients send over a Unix\n"
+        "                            socket, each in a fresh copy of this process\n"
+        "  --connect <socket>        send the program to a server and print what\n"
+        "                            it prints, a filename of - sends stdin\n"
+        "  --stats                   print statistics of the run to stderr\n"
+        "  --stats-json              print the statistics as JSON\n"
+        "  --profile <file>          write the collapsed stacks of every call\n"
+        "                            to the file and print a summary to stderr\n"
+    );
     exit(1);
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2)
+    const char* filename = NULL;
+    int use_vm = 0;
+    int lex_only = 0;
+    int parse_only = 0;
+    const char* flush = NULL;
+    const char* output_buffer = NULL;
+    const char* max_depth = NULL;
+    const char* profile = NULL;
+    int use_cache = 0;
+    const char* cache_dir = NULL;
+    const char* image_file = NULL;
+    const char* dump_image = NULL;
+    const char* serve_socket = NULL;
+    const char* connect_socket = NULL;
+    int print_stats = 0;
+    stats_format_T stats_format = STATS_TEXT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--vm") == 0)
+            use_vm = 1;
+        else if (strcmp(argv[i], "--lex-only") == 0)
+            lex_only = 1;
+        else if (strcmp(argv[i], "--parse-only") == 0)
+            parse_only = 1;
+        else if (strcmp(argv[i], "--cache") == 0)
+            use_cache = use_vm = 1;
+        else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            use_cache = use_vm = 1;
+            cache_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--image") == 0 && i + 1 < argc)
+            image_file = argv[++i];
+        else if (strcmp(argv[i], "--dump-image") == 0 && i + 1 < argc)
+            dump_image = argv[++i];
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
+            serve_socket = argv[++i];
+        else if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc)
+            connect_socket = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            profile = argv[++i];
+        else if (strcmp(argv[i], "--stats") == 0)
+            print_stats = 1;
+        else if (strcmp(argv[i], "--stats-json") == 0) {
+            print_stats = 1;
+            stats_format = STATS_JSON;
+        }
+        else if (strcmp(argv[i], "--flush") == 0 && i + 1 < argc)
+            flush = argv[++i];
+        else if (strcmp(argv[i], "--output-buffer") == 0 && i + 1 < argc)
+            output_buffer = argv[++i];
+        else if (strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc)
+            max_depth = argv[++i];
+        else if (filename == NULL)
+            filename = argv[i];
+        else
+            print_help();
+    }
+
+    if (filename == NULL && serve_socket == NULL)
         print_help();
 
+    if (connect_socket != NULL)
+        return server_connect(connect_socket, filename);
+
+    // The image holds the definitions the tree-walker runs, and the
+    // compiled program of a source depends on the image it started from.
+    if (dump_image != NULL)
+        use_vm = 0;
+
+    if (dump_image != NULL || image_file != NULL)
+        use_cache = 0;
+
+    runtime_T* runtime = init_runtime();
+
+    if (flush != NULL || output_buffer != NULL) {
+        out_flush_T policy = runtime->out->policy;
+        size_t capacity = runtime->out->capacity;
+
+        if (flush == NULL)
+            ;
+        else if (strcmp(flush, "line") == 0)
+            policy = OUT_FLUSH_LINE;
+        else if (strcmp(flush, "block") == 0)
+            policy = OUT_FLUSH_BLOCK;
+        else if (strcmp(flush, "explicit") == 0)
+            policy = OUT_FLUSH_EXPLICIT;
+        else
+            print_help();
+
+        if (output_buffer != NULL) {
+            char* end;
+            capacity = strtoul(output_buffer, &end, 10);
+
+            if (*end != '\0' || capacity == 0)
+                print_help();
+        }
+
+        out_configure(runtime->out, capacity, policy);
+    }
+
+    if (max_depth != NULL) {
+        char* end;
+        runtime->max_depth = strtoul(max_depth, &end, 10);
+
+        if (*end != '\0' || runtime->max_depth == 0)
+            print_help();
+    }
+
+    stats_T* stats = print_stats ? init_stats(runtime->arena, stats_format) : NULL;
+    FILE* profile_file = NULL;
+
+    if (profile != NULL) {
+        profile_file = fopen(profile, "w");
+
+        if (profile_file == NULL) {
+            printf("Could not open profile `%s`\n", profile);
+            exit(1);
+        }
+
+        runtime->profiler = init_profiler();
+    }
+
+    image_T* image = NULL;
+    scope_T* scope = NULL;
+
+    // Declared once up front, so that a server does not declare the
+    // image again for every program it runs.
+    if (image_file != NULL) {
+        stats_begin(stats, STATS_IMAGE);
+        image = image_load(runtime, image_file);
+        scope = init_scope(runtime->arena);
+        image_declare(image, scope);
+        stats_end(stats);
+    }
+
+    source_T* source = NULL;
+
+    if (serve_socket != NULL)
+        source = server_serve(serve_socket, &filename);
+
+    stats_begin(stats, STATS_READ);
+
+    if (source == NULL)
+        source = get_file_source(filename);
+
+    stats_end(stats);
+
     lexer_T* lexer = init_lexer(
-        get_file_contents(argv[1])
+        source->contents,
+        source->length,
+        runtime->arena,
+        runtime->interner
     );
 
-    parser_T* parser = init_parser(lexer);
-    AST_T* root = parser_parse(parser, parser->scope);
-    runtime_T* runtime = init_runtime();
-    runtime_visit(runtime, root);
+    if (lex_only) {
+        token_T* token;
+        stats_begin(stats, STATS_LEX);
+
+        while ((token = lexer_get_next_token(lexer))->type != TOKEN_EOF)
+            lexer_release_token(lexer, token);
+
+        stats_end(stats);
+    } else {
+        chunk_T* chunk = NULL;
+        cache_T* cache = NULL;
+        char* cache_file = NULL;
+        uint64_t key = 0;
+
+        // A program sent as source has no place to keep its cache
+        // unless there is a directory for it.
+        if (use_cache && !parse_only && (filename != NULL || cache_dir != NULL)) {
+            stats_begin(stats, STATS_CACHE);
+            key = cache_key(source->contents, source->length);
+            cache_file = cache_path(filename, cache_dir, key);
+            cache = cache_load(runtime, cache_file, key, source->length);
+            stats_end(stats);
+        }
+
+        if (cache != NULL)
+            chunk = cache->chunk;
+        else {
+            parser_T* parser = init_parser(lexer);
+
+            if (scope == NULL)
+                scope = parser->scope;
+
+            stats_begin(stats, STATS_PARSE);
+            AST_T* root = parser_parse(parser, scope);
+            stats_end(stats);
+            stats_count_nodes(stats, root);
+
+            // Globals restored from an image may be defined again by
+            // the functions of the image.
+            size_t first_global = runtime->globals.size;
+
+            stats_begin(stats, STATS_RESOLVE);
+            resolver_resolve(init_resolver(runtime, scope), root);
+            stats_end(stats);
+
+            stats_begin(stats, STATS_FOLD);
+            folder_T* folder = init_folder(runtime);
+            folder->first_global = first_global;
+            folder->persistent = dump_image != NULL;
+            folder_fold(folder, root);
+            stats_end(stats);
+
+            if (parse_only)
+                ;
+            else if (use_vm) {
+                if (image != NULL)
+                    root = image_prepend_definitions(image, root);
+
+                stats_begin(stats, STATS_COMPILE);
+                chunk = compiler_compile(init_compiler(runtime), root);
+                stats_end(stats);
+
+                if (cache_file != NULL) {
+                    stats_begin(stats, STATS_CACHE);
+                    cache_store(runtime, chunk, cache_file, key, source->length);
+                    stats_end(stats);
+                }
+            } else {
+                stats_begin(stats, STATS_RUN);
+                profiler_start(runtime->profiler);
+                runtime_run(runtime, root);
+                profiler_stop(runtime->profiler);
+                stats_end(stats);
+
+                if (dump_image != NULL) {
+                    stats_begin(stats, STATS_IMAGE);
+                    image_dump(runtime, dump_image);
+                    stats_end(stats);
+                }
+            }
+        }
+
+        if (chunk != NULL) {
+            vm_T* vm = init_vm(runtime);
+            stats_begin(stats, STATS_RUN);
+            profiler_start(runtime->profiler);
+            vm_run(vm, chunk);
+            profiler_stop(runtime->profiler);
+            stats_end(stats);
+            vm_free(vm);
+        }
+
+        if (cache != NULL)
+            cache_free(cache);
+
+        free(cache_file);
+    }
+
+    if (runtime->profiler != NULL) {
+        out_flush(runtime->out);
+        profiler_print_summary(runtime->profiler, stderr);
+        profiler_write_collapsed(runtime->profiler, profile_file);
+        fclose(profile_file);
+        profiler_free(runtime->profiler);
+    }
+
+    if (stats != NULL) {
+        // What the program printed goes out before the statistics.
+        out_flush(runtime->out);
+        stats_record(stats, lexer, scope, runtime);
+        stats_print(stats);
+        stats_free(stats);
+    }
+
+    runtime_free(runtime);
+    source_free(source);
+
+    if (image != NULL)
+        image_free(image);
 
     return 0;
 }
@@ -2,6 +2,7 @@
 #include "include/scope.h"
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 
 /**
  * @brief Initializes and allocates the parser by setting
@@ -11,16 +12,79 @@
  * @return parser Returns newly allocated parser.
  */
 parser_T* init_parser(lexer_T* lexer) {
-    parser_T* parser = calloc(1, sizeof(struct PARSER_STRUCT));
+    parser_T* parser = arena_alloc(lexer->arena, sizeof(struct PARSER_STRUCT));
     parser->lexer = lexer;
     parser->current_token = lexer_get_next_token(lexer);
     parser->prev_token = parser->current_token;
 
-    parser->scope = init_scope();
+    parser->scope = init_scope(lexer->arena);
+
+    parser->keyword_string = interner_intern(lexer->interner, "String", 6);
+    parser->keyword_var = interner_intern(lexer->interner, "var", 3);
+    parser->keyword_fn = interner_intern(lexer->interner, "fn", 2);
+    parser->keyword_true = interner_intern(lexer->interner, "true", 4);
+    parser->keyword_false = interner_intern(lexer->interner, "false", 5);
 
     return parser;
 }
 
+/**
+ * @brief Nests the expression that is being parsed one level deeper,
+ *        reporting an error past PARSER_MAX_DEPTH.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @return void Does not return.
+ */
+void parser_enter(parser_T* parser) {
+    parser->depth += 1;
+
+    if (parser->depth > PARSER_MAX_DEPTH) {
+        error_report(parser->lexer->error, "Expression nested deeper than %d", PARSER_MAX_DEPTH);
+        error_raise(parser->lexer->error, 1);
+    }
+}
+
+/**
+ * @brief Pushes a node of the list that is being parsed.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] node Pointer to the node to push
+ * @return void Does not return.
+ */
+void parser_push(parser_T* parser, AST_T* node) {
+    if (parser->stack_size == parser->stack_capacity) {
+        size_t capacity = parser->stack_capacity ? parser->stack_capacity * 2 : 64;
+        parser->stack = arena_realloc(
+            parser->lexer->arena,
+            parser->stack,
+            parser->stack_capacity * sizeof(struct AST_STRUCT*),
+            capacity * sizeof(struct AST_STRUCT*)
+        );
+        parser->stack_capacity = capacity;
+    }
+
+    parser->stack[parser->stack_size++] = node;
+}
+
+/**
+ * @brief Pops the nodes pushed since the list started and copies
+ *        them into the list of the node that owns them.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] base Size of the stack when the list started
+ * @param[out] list List with room for every node since base
+ * @return void Does not return.
+ */
+void parser_pop_list(parser_T* parser, size_t base, AST_T** list) {
+    size_t size = parser->stack_size - base;
+
+    // The stack is NULL until the first node is pushed.
+    if (size > 0) {
+        memcpy(list, parser->stack + base, size * sizeof(struct AST_STRUCT*));
+    }
+    parser->stack_size = base;
+}
+
 /**
  * @brief Consumes a token and moves to the next if the
  *        current token is the same as the expected token.
@@ -30,16 +94,23 @@ parser_T* init_parser(lexer_T* lexer) {
  * @return void Does not return.
  */
 void parser_consume(parser_T* parser, int token_type) {
-    if (parser->current_token->type == token_type) {
+    if ((int) parser->current_token->type == token_type) {
+        // Nothing holds on to the previous token once it is replaced.
+        if (parser->prev_token != parser->current_token) {
+            lexer_release_token(parser->lexer, parser->prev_token);
+        }
+
         parser->prev_token = parser->current_token;
         parser->current_token = lexer_get_next_token(parser->lexer);
     } else {
-        printf(
-            "Unexpected token `%s`, with type %d\n",
-            parser->current_token->value,
+        error_report(
+            parser->lexer->error,
+            "Unexpected token `%.*s`, with type %d",
+            (int) parser->current_token->length,
+            parser->lexer->contents + parser->current_token->start,
             parser->current_token->type
         );
-        exit(1);
+        error_raise(parser->lexer->error, 1);
     }
 }
 
@@ -63,12 +134,18 @@ AST_T* parser_parse(parser_T* parser, scope_T* scope) {
  */
 AST_T* parser_parse_statement(parser_T* parser, scope_T* scope) {
     switch (parser->current_token->type) {
-        case TOKEN_ID: {
-            return parser_parse_id(parser, scope);
+        case TOKEN_ID:
+        case TOKEN_STRING_VALUE:
+        case TOKEN_INTEGER_VALUE:
+        case TOKEN_FLOAT_VALUE:
+        case TOKEN_LPAREN:
+        case TOKEN_MINUS: {
+            return parser_parse_expr(parser, scope);
         }
+        default: break;
     }
 
-    return init_ast(AST_NOOP);
+    return init_ast(parser->lexer->arena, AST_NOOP);
 }
 
 /**
@@ -79,14 +156,11 @@ AST_T* parser_parse_statement(parser_T* parser, scope_T* scope) {
  * @return AST_T Returns an abstract syntax tree node of proper type(s)
  */
 AST_T* parser_parse_statements(parser_T* parser, scope_T* scope) {
-    AST_T* compound = init_ast(AST_COMPOUND);
-    compound->scope = scope;
-    compound->compound_value = calloc(1, sizeof(struct AST_STRUCT*));
+    size_t base = parser->stack_size;
 
     AST_T* ast_statement = parser_parse_statement(parser, scope);
     ast_statement->scope = scope;
-    compound->compound_value[0] = ast_statement;
-    compound->compound_size += 1;
+    parser_push(parser, ast_statement);
 
     while (parser->current_token->type == TOKEN_SEMI) {
         parser_consume(parser, TOKEN_SEMI);
@@ -94,16 +168,18 @@ AST_T* parser_parse_statements(parser_T* parser, scope_T* scope) {
         AST_T* ast_statement = parser_parse_statement(parser, scope);
 
         if (ast_statement) {
-            compound->compound_size += 1;
-            // Reallocate memory for the compound statement.
-            compound->compound_value = realloc(
-                compound->compound_value,
-                compound->compound_size * sizeof(struct AST_STRUCT*)
-            );
-            compound->compound_value[compound->compound_size-1] = ast_statement;
+            parser_push(parser, ast_statement);
         }
     }
 
+    AST_T* compound = init_ast_list(
+        parser->lexer->arena,
+        AST_COMPOUND,
+        parser->stack_size - base
+    );
+    compound->scope = scope;
+    parser_pop_list(parser, base, compound->compound_value);
+
     return compound;
 }
 
@@ -115,16 +191,130 @@ AST_T* parser_parse_statements(parser_T* parser, scope_T* scope) {
  * @return AST_T Returns an abstract syntax tree node of proper type(s)
  */
 AST_T* parser_parse_expr(parser_T* parser, scope_T* scope) {
+    return parser_parse_binary(parser, scope, 1);
+}
+
+/**
+ * @brief Gives the operator and precedence of a binary operator token.
+ *        Higher precedences bind more tightly.
+ * 
+ * @param[in] token_type Integer value of the token type
+ * @param[out] op Operator of the token, when it is a binary operator
+ * @return int Returns the precedence, or 0 if the token is no binary operator.
+ */
+static int parser_binary_precedence(int token_type, value_op_T* op) {
+    switch (token_type) {
+        case TOKEN_EQUALS_EQUALS: *op = VALUE_OP_EQUAL; return 1;
+        case TOKEN_NOT_EQUALS: *op = VALUE_OP_NOT_EQUAL; return 1;
+        case TOKEN_LESS_THAN: *op = VALUE_OP_LESS; return 2;
+        case TOKEN_LARGER_THAN: *op = VALUE_OP_GREATER; return 2;
+        case TOKEN_LESS_THAN_EQUALS: *op = VALUE_OP_LESS_EQUAL; return 2;
+        case TOKEN_LARGER_THAN_EQUALS: *op = VALUE_OP_GREATER_EQUAL; return 2;
+        case TOKEN_PLUS: *op = VALUE_OP_ADD; return 3;
+        case TOKEN_MINUS: *op = VALUE_OP_SUB; return 3;
+        case TOKEN_STAR: *op = VALUE_OP_MUL; return 4;
+        case TOKEN_DIV: *op = VALUE_OP_DIV; return 4;
+        case TOKEN_PERCENTAGE: *op = VALUE_OP_MOD; return 4;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Parses binary operators that bind at least as tightly as the
+ *        given precedence. Operators of the same precedence group to
+ *        the left.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @param[in] precedence Lowest precedence of the operators to parse
+ * @return AST_T Returns an abstract syntax tree node of proper type(s)
+ */
+AST_T* parser_parse_binary(parser_T* parser, scope_T* scope, int precedence) {
+    size_t depth = parser->depth;
+    AST_T* left = parser_parse_unary(parser, scope);
+    value_op_T op = VALUE_OP_ADD;
+    int op_precedence;
+
+    // Precedences start at 1, so tokens that are no operator end the loop.
+    while ((op_precedence = parser_binary_precedence(parser->current_token->type, &op)) >= precedence) {
+        parser_consume(parser, parser->current_token->type);
+
+        // The left operand ends up one level deeper for every operator.
+        parser_enter(parser);
+
+        AST_T* binary = init_ast(parser->lexer->arena, AST_BINARY);
+        binary->binary_op = op;
+        binary->binary_left = left;
+        binary->binary_right = parser_parse_binary(parser, scope, op_precedence + 1);
+        binary->scope = scope;
+
+        left = binary;
+    }
+
+    parser->depth = depth;
+
+    return left;
+}
+
+/**
+ * @brief Parses a negation or a primary expression.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @return AST_T Returns an abstract syntax tree node of proper type(s)
+ */
+AST_T* parser_parse_unary(parser_T* parser, scope_T* scope) {
+    parser_enter(parser);
+
+    if (parser->current_token->type != TOKEN_MINUS) {
+        AST_T* primary = parser_parse_primary(parser, scope);
+        parser->depth -= 1;
+
+        return primary;
+    }
+
+    parser_consume(parser, TOKEN_MINUS);
+
+    AST_T* negate = init_ast(parser->lexer->arena, AST_NEGATE);
+    negate->negate_value = parser_parse_unary(parser, scope);
+    negate->scope = scope;
+    parser->depth -= 1;
+
+    return negate;
+}
+
+/**
+ * @brief Parses a literal, a name, a definition or an expression
+ *        between parentheses.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @return AST_T Returns an abstract syntax tree node of proper type(s)
+ */
+AST_T* parser_parse_primary(parser_T* parser, scope_T* scope) {
     switch (parser->current_token->type) {
         case TOKEN_STRING_VALUE: {
             return parser_parse_string(parser, scope);
         }
+        case TOKEN_INTEGER_VALUE:
+        case TOKEN_FLOAT_VALUE: {
+            return parser_parse_number(parser, scope);
+        }
         case TOKEN_ID: {
             return parser_parse_id(parser, scope);
         }
+        case TOKEN_LPAREN: {
+            parser_consume(parser, TOKEN_LPAREN);
+            AST_T* ast_expr = parser_parse_expr(parser, scope);
+            parser_consume(parser, TOKEN_RPAREN);
+
+            return ast_expr;
+        }
+        default: break;
     }
 
-    return init_ast(AST_NOOP);
+    return init_ast(parser->lexer->arena, AST_NOOP);
 }
 
 /**
@@ -135,30 +325,32 @@ AST_T* parser_parse_expr(parser_T* parser, scope_T* scope) {
  * @return AST_T Returns an abstract syntax tree node of proper type(s)
  */
 AST_T* parser_parse_fn_call(parser_T* parser, scope_T* scope) {
-    AST_T* fn_call = init_ast(AST_FUNCTION_CALL);
-
-    fn_call->fn_call_name = parser->prev_token->value;
+    const char* fn_call_name = parser->prev_token->value;
     parser_consume(parser, TOKEN_LPAREN); 
 
-    fn_call->fn_call_args = calloc(1, sizeof(struct AST_STRUCT*));
+    size_t base = parser->stack_size;
 
-    AST_T* ast_expr = parser_parse_expr(parser, scope);
-    fn_call->fn_call_args[0] = ast_expr;
-    fn_call->fn_call_args_size += 1;
+    if (parser->current_token->type != TOKEN_RPAREN) {
+        AST_T* ast_expr = parser_parse_expr(parser, scope);
+        parser_push(parser, ast_expr);
 
-    while (parser->current_token->type == TOKEN_COMMA) {
-        parser_consume(parser, TOKEN_COMMA);
+        while (parser->current_token->type == TOKEN_COMMA) {
+            parser_consume(parser, TOKEN_COMMA);
 
-        AST_T* ast_expr = parser_parse_expr(parser, scope);
-        fn_call->fn_call_args_size += 1;
-        fn_call->fn_call_args = realloc(
-            fn_call->fn_call_args,
-            fn_call->fn_call_args_size * sizeof(struct AST_STRUCT*)
-        );
-        fn_call->fn_call_args[fn_call->fn_call_args_size-1] = ast_expr;
+            AST_T* ast_expr = parser_parse_expr(parser, scope);
+            parser_push(parser, ast_expr);
+        }
     }
     parser_consume(parser, TOKEN_RPAREN);
 
+    AST_T* fn_call = init_ast_list(
+        parser->lexer->arena,
+        AST_FUNCTION_CALL,
+        parser->stack_size - base
+    );
+    fn_call->fn_call_name = fn_call_name;
+    parser_pop_list(parser, base, fn_call->fn_call_args);
+
     fn_call->scope = scope;
 
     return fn_call;
@@ -173,12 +365,12 @@ AST_T* parser_parse_fn_call(parser_T* parser, scope_T* scope) {
  */
 AST_T* parser_parse_var_def(parser_T* parser, scope_T* scope) {
     parser_consume(parser, TOKEN_ID); // var
-    char* var_def_var_name = parser->current_token->value;
+    const char* var_def_var_name = parser->current_token->value;
     parser_consume(parser, TOKEN_ID); // var name
     parser_consume(parser, TOKEN_EQUALS);
     AST_T* var_def_value = parser_parse_expr(parser, scope);
 
-    AST_T* var_def = init_ast(AST_VARIABLE_DEFINITION);
+    AST_T* var_def = init_ast(parser->lexer->arena, AST_VARIABLE_DEFINITION);
     var_def->var_def_var_name = var_def_var_name;
     var_def->var_def_value = var_def_value;
 
@@ -195,45 +387,39 @@ AST_T* parser_parse_var_def(parser_T* parser, scope_T* scope) {
  * @return AST_T Returns an abstract syntax tree of proper type(s)
  */
 AST_T* parser_parse_fn_def(parser_T* parser, scope_T* scope) {
-    AST_T* ast = init_ast(AST_FUNCTION_DEFINITION);
     parser_consume(parser, TOKEN_ID); // fn
 
-    char* fn_name = parser->current_token->value;
-    ast->fn_def_name = calloc(
-            strlen(fn_name) + 1, sizeof(char)
-    );
-    strcpy(ast->fn_def_name, fn_name);
+    const char* fn_def_name = parser->current_token->value;
 
     parser_consume(parser, TOKEN_ID); // fn name
 
     parser_consume(parser, TOKEN_LPAREN); // fn left paren "("
 
-    // Allocate memory for function arguments.
-    ast->fn_def_args =
-        calloc(1, sizeof(struct AST_STRUCT*));
-
-    // Start parsing arguments
-    AST_T* arg = parser_parse_var(parser, scope);
-    ast->fn_def_args_size += 1;
-    ast->fn_def_args[ast->fn_def_args_size-1] = arg;
+    size_t base = parser->stack_size;
 
-    // Continue to parse arguments as long as it is encountering a comma.
-    while (parser->current_token->type == TOKEN_COMMA) {
-        parser_consume(parser, TOKEN_COMMA);
+    // Start parsing arguments, unless there are none
+    if (parser->current_token->type != TOKEN_RPAREN) {
+        AST_T* arg = parser_parse_var(parser, scope);
+        parser_push(parser, arg);
 
-        ast->fn_def_args_size += 1;
-        // Reallocate memory for each argument.
-        ast->fn_def_args =
-            realloc(
-                    ast->fn_def_args,
-                    ast->fn_def_args_size * sizeof(struct AST_STRUCT*)
-                   );
+        // Continue to parse arguments as long as it is encountering a comma.
+        while (parser->current_token->type == TOKEN_COMMA) {
+            parser_consume(parser, TOKEN_COMMA);
 
-        AST_T* arg = parser_parse_var(parser, scope);
-        ast->fn_def_args[ast->fn_def_args_size-1] = arg;
+            AST_T* arg = parser_parse_var(parser, scope);
+            parser_push(parser, arg);
+        }
     }
 
     parser_consume(parser, TOKEN_RPAREN); // fn right paren ")"
+
+    AST_T* ast = init_ast_list(
+        parser->lexer->arena,
+        AST_FUNCTION_DEFINITION,
+        parser->stack_size - base
+    );
+    ast->fn_def_name = fn_def_name;
+    parser_pop_list(parser, base, ast->fn_def_args);
     
     parser_consume(parser, TOKEN_LBRACE); // fn left brace "{"
     
@@ -254,15 +440,14 @@ AST_T* parser_parse_fn_def(parser_T* parser, scope_T* scope) {
  * @return AST_T Returns an abstract syntax tree node for variable of proper type.
  */
 AST_T* parser_parse_var(parser_T* parser, scope_T* scope) {
-    char* token_value = parser->current_token->value;
     parser_consume(parser, TOKEN_ID); // var name or fn call name
 
     if (parser->current_token->type == TOKEN_LPAREN) {
         return parser_parse_fn_call(parser, scope);
     }
 
-    AST_T* ast_var = init_ast(AST_VARIABLE);
-    ast_var->var_name = token_value;
+    AST_T* ast_var = init_ast(parser->lexer->arena, AST_VARIABLE);
+    ast_var->var_name = parser->prev_token->value;
 
     ast_var->scope = scope;
 
@@ -277,7 +462,7 @@ AST_T* parser_parse_var(parser_T* parser, scope_T* scope) {
  * @return AST_T Returns an abstract syntax tree node of type string.
  */
 AST_T* parser_parse_string(parser_T* parser, scope_T* scope) {
-    AST_T* ast_string = init_ast(AST_STRING);
+    AST_T* ast_string = init_ast(parser->lexer->arena, AST_STRING);
     ast_string->string_value = parser->current_token->value;
 
     parser_consume(parser, TOKEN_STRING_VALUE);
@@ -288,17 +473,75 @@ AST_T* parser_parse_string(parser_T* parser, scope_T* scope) {
 }
 
 /**
- * @brief Parses a variable definition.
+ * @brief Parses an integer or float literal. Integers that do not fit
+ *        in 32 bits become floats.
+ * 
+ * @param[in] parser Pointer to parser struct
+ * @param[in] scope Pointer to scope struct
+ * @return AST_T Returns an abstract syntax tree node of type integer or float.
+ */
+AST_T* parser_parse_number(parser_T* parser, scope_T* scope) {
+    token_T* token = parser->current_token;
+    int type = token->type;
+
+    // The contents are not NUL-terminated, strtod needs a copy.
+    char buffer[64];
+    char* digits = buffer;
+
+    if (token->length < sizeof(buffer)) {
+        memcpy(buffer, parser->lexer->contents + token->start, token->length);
+        buffer[token->length] = '\0';
+    } else {
+        digits = arena_strndup(parser->lexer->arena, parser->lexer->contents + token->start, token->length);
+    }
+
+    parser_consume(parser, type);
+
+    AST_T* ast_number;
+
+    if (type == TOKEN_INTEGER_VALUE) {
+        errno = 0;
+        long long integer = strtoll(digits, NULL, 10);
+
+        if (errno == 0 && integer <= INT32_MAX) {
+            ast_number = init_ast(parser->lexer->arena, AST_INTEGER);
+            ast_number->integer_value = (int32_t) integer;
+            ast_number->scope = scope;
+
+            return ast_number;
+        }
+    }
+
+    ast_number = init_ast(parser->lexer->arena, AST_FLOAT);
+    ast_number->float_value = strtod(digits, NULL);
+    ast_number->scope = scope;
+
+    return ast_number;
+}
+
+/**
+ * @brief Parses a definition, a boolean literal or a variable,
+ *        depending on the keyword it starts with.
  * 
  * @param[in] parser Pointer to parser struct
  * @param[in] scope Pointer to scope struct
  * @return AST_T Returns an abstract syntax tree of proper type(s)
  */
 AST_T* parser_parse_id(parser_T* parser, scope_T* scope) {
-    if (strcmp(parser->current_token->value, "String") == 0) {
+    const char* value = parser->current_token->value;
+
+    if (value == parser->keyword_string || value == parser->keyword_var) {
         return parser_parse_var_def(parser, scope);
-    } else if (strcmp(parser->current_token->value, "fn") == 0) {
+    } else if (value == parser->keyword_fn) {
         return parser_parse_fn_def(parser, scope);
+    } else if (value == parser->keyword_true || value == parser->keyword_false) {
+        parser_consume(parser, TOKEN_ID);
+
+        AST_T* ast_boolean = init_ast(parser->lexer->arena, AST_BOOLEAN);
+        ast_boolean->boolean_value = value == parser->keyword_true;
+        ast_boolean->scope = scope;
+
+        return ast_boolean;
     } else {
         return parser_parse_var(parser, scope);
     }
@@ -0,0 +1,417 @@
+#include "include/profiler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PROFILER_FUNCTIONS_CAPACITY 64
+
+/* Node whose path is still to be written, behind the path of its
+   parent which is length characters long. */
+typedef struct PROFILE_PENDING_STRUCT
+{
+    profile_node_T* node;
+    size_t length;
+} profile_pending_T;
+
+/**
+ * @brief Reads the monotonic clock.
+ *
+ * @param[in] NONE
+ * @return time Returns the time in nanoseconds.
+ */
+static uint64_t profiler_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * @brief Finds the slot of a key in the map of functions. The key
+ *        itself is hashed and compared.
+ *
+ * @param[in] functions Slots of the map.
+ * @param[in] capacity Capacity of the map, a power of two.
+ * @param[in] key Identity of the function.
+ * @return slot Returns the slot holding the function of the key,
+ *         or the empty slot where it belongs.
+ */
+static profile_function_T** profiler_find(profile_function_T** functions, size_t capacity, const void* key) {
+    size_t i = (size_t) (((uintptr_t) key >> 3) * 11400714819323198485ULL) & (capacity - 1);
+
+    while (functions[i] != NULL && functions[i]->key != key) {
+        i = (i + 1) & (capacity - 1);
+    }
+
+    return &functions[i];
+}
+
+/**
+ * @brief Gives the totals of a function, adding them on its first
+ *        call and doubling the capacity of the map when it would
+ *        become more than half full.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] key Identity of the function.
+ * @param[in] name Interned name of the function.
+ * @return function Returns the totals of the function.
+ */
+static profile_function_T* profiler_function(profiler_T* profiler, const void* key, const char* name) {
+    if ((profiler->functions_size + 1) * 2 > profiler->functions_capacity) {
+        profile_function_T** functions = profiler->functions;
+        size_t capacity = profiler->functions_capacity;
+
+        profiler->functions_capacity = capacity ? capacity * 2 : PROFILER_FUNCTIONS_CAPACITY;
+        profiler->functions = arena_alloc(
+            profiler->arena,
+            profiler->functions_capacity * sizeof(struct PROFILE_FUNCTION_STRUCT*)
+        );
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (functions[i] != NULL) {
+                *profiler_find(profiler->functions, profiler->functions_capacity, functions[i]->key) = functions[i];
+            }
+        }
+    }
+
+    profile_function_T** slot = profiler_find(profiler->functions, profiler->functions_capacity, key);
+
+    if (*slot == NULL) {
+        *slot = arena_alloc(profiler->arena, sizeof(struct PROFILE_FUNCTION_STRUCT));
+        (*slot)->key = key;
+        (*slot)->name = name;
+        profiler->functions_size += 1;
+    }
+
+    return *slot;
+}
+
+/**
+ * @brief Initializes and allocates the profiler, with the top level
+ *        of the program as the root of the calling context tree.
+ *
+ * @param[in] NONE
+ * @return profiler Returns newly allocated profiler.
+ */
+profiler_T* init_profiler() {
+    profiler_T* profiler = calloc(1, sizeof(struct PROFILER_STRUCT));
+    profiler->arena = init_arena(0);
+
+    profiler->root = arena_alloc(profiler->arena, sizeof(struct PROFILE_NODE_STRUCT));
+    profiler->root->function = profiler_function(profiler, profiler, "main");
+
+    return profiler;
+}
+
+/**
+ * @brief Releases the profiler and everything it recorded.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @return void Does not return.
+ */
+void profiler_free(profiler_T* profiler) {
+    arena_free(profiler->arena);
+    free(profiler->calls);
+    free(profiler);
+}
+
+/**
+ * @brief Gives the child of a node for a function, adding it on the
+ *        first call of the function from the node.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] parent Pointer to the node of the caller.
+ * @param[in] key Identity of the called function.
+ * @param[in] name Interned name of the called function.
+ * @return node Returns the node of the called function.
+ */
+static profile_node_T* profiler_child(profiler_T* profiler, profile_node_T* parent, const void* key, const char* name) {
+    profile_node_T* prev = NULL;
+    profile_node_T* node = parent->child;
+
+    while (node != NULL && node->function->key != key) {
+        prev = node;
+        node = node->sibling;
+    }
+
+    if (node == NULL) {
+        node = arena_alloc(profiler->arena, sizeof(struct PROFILE_NODE_STRUCT));
+        node->function = profiler_function(profiler, key, name);
+        node->parent = parent;
+        node->sibling = parent->child;
+        parent->child = node;
+    } else if (prev != NULL) {
+        // Move the child to the front, callers tend to repeat calls.
+        prev->sibling = node->sibling;
+        node->sibling = parent->child;
+        parent->child = node;
+    }
+
+    return node;
+}
+
+/**
+ * @brief Pushes an active call of a node.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] node Pointer to the called node.
+ * @param[in] tail Whether the call is a tail call.
+ * @return void Does not return.
+ */
+static void profiler_push(profiler_T* profiler, profile_node_T* node, int tail) {
+    if (profiler->calls_size == profiler->calls_capacity) {
+        profiler->calls_capacity = profiler->calls_capacity ? profiler->calls_capacity * 2 : 64;
+        profiler->calls = realloc(
+            profiler->calls,
+            profiler->calls_capacity * sizeof(struct PROFILE_CALL_STRUCT)
+        );
+    }
+
+    profile_call_T* call = &profiler->calls[profiler->calls_size++];
+    call->node = node;
+    call->children = 0;
+    call->tail = tail;
+    node->function->active += 1;
+
+    // Read last, so that the bookkeeping is not timed as the call.
+    call->start = profiler_now();
+}
+
+/**
+ * @brief Pops the active call and adds its time to its node, its
+ *        function and the call below it.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @return tail Returns whether the call was a tail call.
+ */
+static int profiler_pop(profiler_T* profiler) {
+    uint64_t now = profiler_now();
+    profile_call_T* call = &profiler->calls[--profiler->calls_size];
+    uint64_t elapsed = now - call->start;
+    profile_node_T* node = call->node;
+    profile_function_T* function = node->function;
+
+    node->calls += 1;
+    node->inclusive += elapsed;
+    node->exclusive += elapsed - call->children;
+
+    function->calls += 1;
+    function->exclusive += elapsed - call->children;
+
+    if (--function->active == 0) {
+        function->inclusive += elapsed;
+    }
+
+    if (profiler->calls_size > 0) {
+        profiler->calls[profiler->calls_size - 1].children += elapsed;
+    }
+
+    return call->tail;
+}
+
+/**
+ * @brief Starts timing the top level of the program.
+ *
+ * @param[in] profiler Pointer to the profiler struct, or NULL when
+ *            the run is not profiled.
+ * @return void Does not return.
+ */
+void profiler_start(profiler_T* profiler) {
+    if (profiler == NULL) {
+        return;
+    }
+
+    profiler_push(profiler, profiler->root, 0);
+}
+
+/**
+ * @brief Stops timing the top level of the program, together with
+ *        every call that is still active.
+ *
+ * @param[in] profiler Pointer to the profiler struct, or NULL when
+ *            the run is not profiled.
+ * @return void Does not return.
+ */
+void profiler_stop(profiler_T* profiler) {
+    while (profiler != NULL && profiler->calls_size > 0) {
+        profiler_pop(profiler);
+    }
+}
+
+/**
+ * @brief Records the start of a call, as a child of the call that
+ *        is active.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] key Identity of the called function.
+ * @param[in] name Interned name of the called function.
+ * @return void Does not return.
+ */
+void profiler_enter(profiler_T* profiler, const void* key, const char* name) {
+    profile_node_T* parent = profiler->calls[profiler->calls_size - 1].node;
+    profiler_push(profiler, profiler_child(profiler, parent, key, name), 0);
+}
+
+/**
+ * @brief Records the start of a tail call, as a child of the call
+ *        that makes it. When the function is already called by the
+ *        chain of tail calls that leads here, the chain is cut back to
+ *        that call instead, so that a loop of tail calls stays flat.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] key Identity of the called function.
+ * @param[in] name Interned name of the called function.
+ * @return void Does not return.
+ */
+void profiler_tail(profiler_T* profiler, const void* key, const char* name) {
+    size_t i = profiler->calls_size - 1;
+
+    // The chain is made of the tail calls on top and the call below
+    // them, which is the one that started it.
+    while (profiler->calls[i].node->function->key != key) {
+        if (!profiler->calls[i].tail) {
+            profile_node_T* parent = profiler->calls[profiler->calls_size - 1].node;
+            profiler_push(profiler, profiler_child(profiler, parent, key, name), 1);
+            return;
+        }
+
+        i--;
+    }
+
+    profile_node_T* node = profiler->calls[i].node;
+    int tail = profiler->calls[i].tail;
+
+    while (profiler->calls_size > i) {
+        profiler_pop(profiler);
+    }
+
+    profiler_push(profiler, node, tail);
+}
+
+/**
+ * @brief Records the end of the call that is active, and of the
+ *        calls whose tail calls led to it.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @return void Does not return.
+ */
+void profiler_exit(profiler_T* profiler) {
+    while (profiler_pop(profiler)) {
+        continue;
+    }
+}
+
+/**
+ * @brief Orders functions by exclusive time, the most first.
+ *
+ * @param[in] a Pointer to the first function.
+ * @param[in] b Pointer to the second function.
+ * @return int Returns the order of the functions.
+ */
+static int profiler_compare(const void* a, const void* b) {
+    const profile_function_T* left = *(profile_function_T* const*) a;
+    const profile_function_T* right = *(profile_function_T* const*) b;
+
+    return (left->exclusive < right->exclusive) - (left->exclusive > right->exclusive);
+}
+
+/**
+ * @brief Prints the calls, inclusive and exclusive time of every
+ *        function, the functions with the most exclusive time first.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] file File to print to.
+ * @return void Does not return.
+ */
+void profiler_print_summary(profiler_T* profiler, FILE* file) {
+    profile_function_T** functions = malloc(profiler->functions_size * sizeof(struct PROFILE_FUNCTION_STRUCT*));
+    size_t size = 0;
+
+    for (size_t i = 0; i < profiler->functions_capacity; i++) {
+        if (profiler->functions[i] != NULL) {
+            functions[size++] = profiler->functions[i];
+        }
+    }
+
+    qsort(functions, size, sizeof(struct PROFILE_FUNCTION_STRUCT*), profiler_compare);
+
+    double total = profiler->root->inclusive ? profiler->root->inclusive : 1;
+
+    fprintf(file, "%-24s %12s %14s %14s %8s\n", "function", "calls", "inclusive ms", "exclusive ms", "self");
+
+    for (size_t i = 0; i < size; i++) {
+        profile_function_T* function = functions[i];
+
+        fprintf(
+            file,
+            "%-24s %12zu %14.3f %14.3f %7.2f%%\n",
+            function->name,
+            function->calls,
+            function->inclusive * 1e-6,
+            function->exclusive * 1e-6,
+            100 * function->exclusive / total
+        );
+    }
+
+    free(functions);
+}
+
+/**
+ * @brief Writes every path of calls as a collapsed stack, the names
+ *        separated by semicolons and followed by the exclusive time
+ *        of the path in nanoseconds, the input of flame graph tools.
+ *
+ * @param[in] profiler Pointer to the profiler struct.
+ * @param[in] file File to write to.
+ * @return void Does not return.
+ */
+void profiler_write_collapsed(profiler_T* profiler, FILE* file) {
+    // Paths can be as deep as the calls, so the tree is walked with
+    // a stack instead of recursion.
+    size_t pending_capacity = 64;
+    profile_pending_T* pending = malloc(pending_capacity * sizeof(struct PROFILE_PENDING_STRUCT));
+    size_t pending_size = 0;
+
+    size_t path_capacity = 256;
+    char* path = malloc(path_capacity);
+
+    pending[pending_size++] = (profile_pending_T) { profiler->root, 0 };
+
+    while (pending_size > 0) {
+        profile_pending_T next = pending[--pending_size];
+        const char* name = next.node->function->name;
+        size_t name_length = strlen(name);
+        size_t length = next.length + (next.length > 0) + name_length;
+
+        if (length + 1 > path_capacity) {
+            while (length + 1 > path_capacity) {
+                path_capacity *= 2;
+            }
+
+            path = realloc(path, path_capacity);
+        }
+
+        if (next.length > 0) {
+            path[next.length] = ';';
+        }
+
+        memcpy(path + length - name_length, name, name_length);
+        path[length] = '\0';
+
+        if (next.node->exclusive > 0) {
+            fprintf(file, "%s %llu\n", path, (unsigned long long) next.node->exclusive);
+        }
+
+        for (profile_node_T* child = next.node->child; child != NULL; child = child->sibling) {
+            if (pending_size == pending_capacity) {
+                pending_capacity *= 2;
+                pending = realloc(pending, pending_capacity * sizeof(struct PROFILE_PENDING_STRUCT));
+            }
+
+            pending[pending_size++] = (profile_pending_T) { child, length };
+        }
+    }
+
+    free(pending);
+    free(path);
+}
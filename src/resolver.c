@@ -0,0 +1,242 @@
+#include "include/resolver.h"
+#include <stdio.h>
+
+/**
+ * @brief Initializes and allocates the resolver. The scope is used
+ *        as the table of global names, every name in it is bound to
+ *        a global of the runtime.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] scope Pointer to the scope struct of the program.
+ * @return resolver Returns newly allocated resolver.
+ */
+resolver_T* init_resolver(runtime_T* runtime, scope_T* scope) {
+    resolver_T* resolver = arena_alloc(runtime->arena, sizeof(struct RESOLVER_STRUCT));
+    resolver->runtime = runtime;
+    resolver->scope = scope;
+    resolver->fdef = NULL;
+    resolver->errors = 0;
+
+    return resolver;
+}
+
+/**
+ * @brief Resolves a parsed program before it runs. Every variable and
+ *        function definition is given the index of a global of the
+ *        runtime, every variable is bound to an argument slot of its
+ *        function or to a global, and every call to a global function.
+ *        Undefined names are reported as errors of the runtime.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return void Does not return.
+ */
+void resolver_resolve(resolver_T* resolver, AST_T* root) {
+    // Definitions are declared first, so that a function body
+    // may refer to anything defined anywhere in the program.
+    resolver_declare(resolver, root);
+    resolver_bind(resolver, root);
+
+    if (resolver->errors > 0) {
+        error_raise(&resolver->runtime->error, 1);
+    }
+}
+
+/**
+ * @brief Gives every definition below a node its global index.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void resolver_declare(resolver_T* resolver, AST_T* node) {
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            // Every definition of a name shares the global of the first one.
+            AST_T* vdef = scope_get_var_def(resolver->scope, node->var_def_var_name);
+
+            if (vdef == NULL) {
+                node->var_def_index = runtime_add_global(
+                    resolver->runtime,
+                    node->var_def_var_name
+                );
+                scope_add_var_def(resolver->scope, node);
+            } else {
+                node->var_def_index = vdef->var_def_index;
+            }
+
+            resolver_declare(resolver, node->var_def_value);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            AST_T* fdef = scope_get_fn_def(resolver->scope, node->fn_def_name);
+
+            if (fdef == NULL) {
+                node->fn_def_index = runtime_add_function(
+                    resolver->runtime,
+                    node->fn_def_name
+                );
+                scope_add_fn_def(resolver->scope, node);
+            } else {
+                node->fn_def_index = fdef->fn_def_index;
+            }
+
+            resolver_declare(resolver, node->fn_def_body);
+            break;
+        }
+        case AST_BINARY: {
+            resolver_declare(resolver, node->binary_left);
+            resolver_declare(resolver, node->binary_right);
+            break;
+        }
+        case AST_NEGATE: {
+            resolver_declare(resolver, node->negate_value);
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                resolver_declare(resolver, node->fn_call_args[i]);
+            }
+            break;
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                resolver_declare(resolver, node->compound_value[i]);
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+/**
+ * @brief Binds a call to a builtin and checks its amount of arguments.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] node Pointer to the call node.
+ * @param[in] builtin Index of the builtin.
+ * @return void Does not return.
+ */
+void resolver_bind_builtin(resolver_T* resolver, AST_T* node, size_t builtin) {
+    builtin_T* entry = &resolver->runtime->builtins.entries[builtin];
+
+    if (entry->flags & BUILTIN_VARIADIC) {
+        if (node->fn_call_args_size < entry->arity) {
+            error_report(
+                &resolver->runtime->error,
+                "Method `%s` expects at least %zu arguments, got %zu",
+                node->fn_call_name,
+                entry->arity,
+                node->fn_call_args_size
+            );
+            resolver->errors += 1;
+        }
+    } else if (node->fn_call_args_size != entry->arity) {
+        error_report(
+            &resolver->runtime->error,
+            "Method `%s` expects %zu arguments, got %zu",
+            node->fn_call_name,
+            entry->arity,
+            node->fn_call_args_size
+        );
+        resolver->errors += 1;
+    }
+
+    node->fn_call_builtin = 1;
+    node->fn_call_index = builtin;
+}
+
+/**
+ * @brief Binds every variable and call below a node.
+ * 
+ * @param[in] resolver Pointer to the resolver struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void resolver_bind(resolver_T* resolver, AST_T* node) {
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            resolver_bind(resolver, node->var_def_value);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            for (size_t i = 0; i < node->fn_def_args_size; i++) {
+                if (node->fn_def_args[i]->type != AST_VARIABLE) {
+                    error_report(&resolver->runtime->error, "Expected argument name in method `%s`", node->fn_def_name);
+                    resolver->errors += 1;
+                }
+            }
+
+            // Functions do not capture, a body only sees its own
+            // arguments and the globals.
+            AST_T* fdef = resolver->fdef;
+            resolver->fdef = node;
+            resolver_bind(resolver, node->fn_def_body);
+            resolver->fdef = fdef;
+            break;
+        }
+        case AST_VARIABLE: {
+            if (resolver->fdef != NULL) {
+                for (size_t i = 0; i < resolver->fdef->fn_def_args_size; i++) {
+                    if (resolver->fdef->fn_def_args[i]->var_name == node->var_name) {
+                        node->var_local = 1;
+                        node->var_index = i;
+                        return;
+                    }
+                }
+            }
+
+            AST_T* vdef = scope_get_var_def(resolver->scope, node->var_name);
+
+            if (vdef == NULL) {
+                error_report(&resolver->runtime->error, "Undefined var `%s`", node->var_name);
+                resolver->errors += 1;
+                break;
+            }
+
+            node->var_local = 0;
+            node->var_index = vdef->var_def_index;
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                resolver_bind(resolver, node->fn_call_args[i]);
+            }
+
+            // Builtins are bound before functions of the program.
+            long builtin = builtins_find(&resolver->runtime->builtins, node->fn_call_name);
+
+            if (builtin >= 0) {
+                resolver_bind_builtin(resolver, node, builtin);
+                break;
+            }
+
+            AST_T* fdef = scope_get_fn_def(resolver->scope, node->fn_call_name);
+
+            if (fdef == NULL) {
+                error_report(&resolver->runtime->error, "Undefined method `%s`", node->fn_call_name);
+                resolver->errors += 1;
+                break;
+            }
+
+            node->fn_call_index = fdef->fn_def_index;
+            break;
+        }
+        case AST_BINARY: {
+            resolver_bind(resolver, node->binary_left);
+            resolver_bind(resolver, node->binary_right);
+            break;
+        }
+        case AST_NEGATE: {
+            resolver_bind(resolver, node->negate_value);
+            break;
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                resolver_bind(resolver, node->compound_value[i]);
+            }
+            break;
+        }
+        default: break;
+    }
+}
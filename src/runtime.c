@@ -1,56 +1,546 @@
 #include "include/runtime.h"
-#include "include/scope.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 /**
- * @brief Builting function for Blink's print function.
+ * @brief Formats an integer in decimal, backwards from the end of
+ *        a buffer of at least 21 characters.
+ * 
+ * @param[in] end Pointer past the last character to format.
+ * @param[in] number Integer to format.
+ * @return start Returns a pointer to the first formatted character.
+ */
+static char* runtime_format_integer(char* end, int64_t number) {
+    uint64_t digits = number < 0 ? -(uint64_t) number : (uint64_t) number;
+    char* p = end;
+
+    do {
+        *--p = '0' + digits % 10;
+        digits /= 10;
+    } while (digits > 0);
+
+    if (number < 0) {
+        *--p = '-';
+    }
+
+    return p;
+}
+
+/**
+ * @brief Prints a value on its own line the way the print builtin does.
  * 
  * @param[in] runtime Pointer to the runtime struct.
- * @param[in] args List of arguments for the Print function.
- * @param[in] args_size Integer of arguments size.
- * @return parser Abstract syntax tree node of proper type.
+ * @param[in] value Value to print.
+ * @return void Does not return.
  */
-static AST_T* builtin_fn_print(runtime_T* runtime, AST_T** args, int args_size) {
-    for (int i = 0; i < args_size; i++) {
-        AST_T* visited_ast = runtime_visit(runtime, args[i]);
+void runtime_print_value(runtime_T* runtime, value_T value) {
+    // Large enough for any int32 or double and the newline.
+    char buffer[32];
+    const char* text = buffer;
+    size_t length;
 
-        switch (visited_ast->type) {
-            case AST_STRING: {
-                printf("%s\n", visited_ast->string_value);
-                break;
-            }
-            default: {
-                printf("%p\n", visited_ast);
-                break;
-            }
+    if (value_is_string(value)) {
+        // Strings are copied as they are, followed by the newline.
+        text = value_as_string(value);
+        length = strlen(text);
+        out_write(runtime->out, text, length);
+        out_write(runtime->out, "\n", 1);
+        return;
+    } else if (value_is_int(value)) {
+        buffer[sizeof(buffer) - 1] = '\n';
+        text = runtime_format_integer(buffer + sizeof(buffer) - 1, value_as_int(value));
+        length = buffer + sizeof(buffer) - text;
+    } else if (value_is_double(value)) {
+        double number = value_as_double(value);
+
+        // Whole numbers below 1e14 print the same as with %.14g,
+        // without the cost of formatting a double.
+        if (number > -1e14 && number < 1e14 && number == (int64_t) number
+                && (number != 0 || !signbit(number))) {
+            buffer[sizeof(buffer) - 1] = '\n';
+            text = runtime_format_integer(buffer + sizeof(buffer) - 1, (int64_t) number);
+            length = buffer + sizeof(buffer) - text;
+        } else {
+            length = snprintf(buffer, sizeof(buffer), "%.14g\n", number);
         }
+    } else if (value_is_bool(value)) {
+        text = value == VALUE_TRUE ? "true\n" : "false\n";
+        length = strlen(text);
+    } else if (value_is_function(value)) {
+        length = snprintf(buffer, sizeof(buffer), "<fn %p>\n", value_as_function(value));
+    } else {
+        text = "nil\n";
+        length = 4;
     }
 
-    return init_ast(AST_NOOP);
+    out_write(runtime->out, text, length);
+}
+
+/**
+ * @brief Reports an error of a running program and exits, or jumps
+ *        back to the host when it has set a jump. Everything the
+ *        program printed is flushed before the error.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] format Format string of the message, without newline.
+ * @return void Does not return.
+ */
+void runtime_error(runtime_T* runtime, const char* format, ...) {
+    va_list args;
+
+    out_flush(runtime->out);
+
+    va_start(args, format);
+    error_vreport(&runtime->error, format, args);
+    va_end(args);
+
+    error_raise(&runtime->error, 1);
+}
+
+/**
+ * @brief Reports an operation that failed and exits.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] op Name of the operator.
+ * @param[in] status Why the operation failed.
+ * @return void Does not return.
+ */
+void runtime_error_operation(runtime_T* runtime, const char* op, value_status_T status) {
+    if (status == VALUE_ERROR_DIVISION_BY_ZERO) {
+        runtime_error(runtime, "Division by zero");
+    }
+
+    runtime_error(runtime, "Unsupported operand types for `%s`", op);
 }
 
 /**
  * @brief Initializes and allocates the runtime struct
+ *        together with the arena and interner it owns.
  * 
  * @param[in] NONE
  * @return parser Returns newly allocated runtime.
  */
 runtime_T* init_runtime() {
     runtime_T* runtime = calloc(1, sizeof(struct RUNTIME_STRUCT));
+    runtime->arena = init_arena(0);
+    runtime->interner = init_interner(runtime->arena);
+
+    runtime->functions_version = 1;
+    runtime->max_depth = RUNTIME_MAX_DEPTH;
+    runtime->out = init_out(STDOUT_FILENO);
+
+    builtins_register_defaults(runtime);
 
     return runtime;
 }
 
+/**
+ * @brief Releases the arena of the runtime, and with it everything
+ *        that was lexed, parsed and run, its call stack, globals and
+ *        the runtime itself.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void runtime_free(runtime_T* runtime) {
+    if (runtime->stack != NULL) {
+        munmap(runtime->stack, runtime->stack_size);
+    }
+
+    out_free(runtime->out);
+    arena_free(runtime->arena);
+    free(runtime->slots);
+    free(runtime->frames);
+    free(runtime->globals.names);
+    free(runtime->globals.values);
+    free(runtime->functions.names);
+    free(runtime->functions.values);
+    free(runtime->builtins.entries);
+    free(runtime);
+}
+
+/**
+ * @brief Forgets everything that was lexed, parsed and run, keeping
+ *        the builtins, the configuration and the memory of the
+ *        runtime for the next program.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void runtime_reset(runtime_T* runtime) {
+    builtins_T* builtins = &runtime->builtins;
+    size_t length = 0;
+
+    out_flush(runtime->out);
+
+    // The names of the builtins live in the arena, they are kept
+    // aside and interned again.
+    for (size_t i = 0; i < builtins->size; i++) {
+        length += strlen(builtins->entries[i].name) + 1;
+    }
+
+    char* names = malloc(length);
+    char* name = names;
+
+    for (size_t i = 0; i < builtins->size; i++) {
+        size_t size = strlen(builtins->entries[i].name) + 1;
+        memcpy(name, builtins->entries[i].name, size);
+        name += size;
+    }
+
+    arena_reset(runtime->arena);
+    runtime->interner = init_interner(runtime->arena);
+    name = names;
+
+    for (size_t i = 0; i < builtins->size; i++) {
+        size_t size = strlen(name);
+        builtins->entries[i].name = interner_intern(runtime->interner, name, size);
+        name += size + 1;
+    }
+
+    free(names);
+
+    runtime->globals.size = 0;
+    runtime->functions.size = 0;
+    runtime->functions_version = 1;
+    runtime->slots_size = 0;
+    runtime->frames_size = 0;
+    memset(&runtime->error, 0, sizeof(runtime->error));
+}
+
+/**
+ * @brief Appends an undefined global, doubling the capacity
+ *        when it is used up.
+ * 
+ * @param[in] globals Pointer to the globals.
+ * @param[in] name Interned string of the name of the global.
+ * @return index Returns the index of the new global.
+ */
+static size_t runtime_add_entry(globals_T* globals, const char* name) {
+    if (globals->size == globals->capacity) {
+        globals->capacity = globals->capacity ? globals->capacity * 2 : 16;
+        globals->names = realloc(globals->names, globals->capacity * sizeof(char*));
+        globals->values = realloc(globals->values, globals->capacity * sizeof(value_T));
+    }
+
+    globals->names[globals->size] = name;
+    globals->values[globals->size] = VALUE_UNDEFINED;
+
+    return globals->size++;
+}
+
+/**
+ * @brief Registers a native function that programs can call by name.
+ *        Calls bind to it when they are resolved, so it must be
+ *        registered before the program that uses it is resolved.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] name String of the name the builtin is called by.
+ * @param[in] fn Pointer to the native function.
+ * @param[in] arity Amount of arguments, the least amount if variadic.
+ * @param[in] flags BUILTIN_VARIADIC or 0.
+ * @return index Returns the index of the builtin.
+ */
+size_t runtime_register_builtin(runtime_T* runtime, const char* name, builtin_fn_T fn, size_t arity, int flags) {
+    builtins_T* builtins = &runtime->builtins;
+
+    if (builtins->size == builtins->capacity) {
+        builtins->capacity = builtins->capacity ? builtins->capacity * 2 : 8;
+        builtins->entries = realloc(builtins->entries, builtins->capacity * sizeof(struct BUILTIN_STRUCT));
+    }
+
+    builtin_T* builtin = &builtins->entries[builtins->size];
+    builtin->name = interner_intern(runtime->interner, name, strlen(name));
+    builtin->fn = fn;
+    builtin->arity = arity;
+    builtin->flags = flags;
+
+    return builtins->size++;
+}
+
+/**
+ * @brief Adds a variable global, which stays undefined
+ *        until a definition bound to it runs.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] name Interned string of the variable name.
+ * @return index Returns the index of the new global.
+ */
+size_t runtime_add_global(runtime_T* runtime, const char* name) {
+    return runtime_add_entry(&runtime->globals, name);
+}
+
+/**
+ * @brief Adds a function global, which stays undefined
+ *        until a definition bound to it runs.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] name Interned string of the function name.
+ * @return index Returns the index of the new global.
+ */
+size_t runtime_add_function(runtime_T* runtime, const char* name) {
+    return runtime_add_entry(&runtime->functions, name);
+}
+
+/**
+ * @brief Pushes a value onto the argument slots, doubling their
+ *        capacity when they are used up.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] value Value of the argument.
+ * @return void Does not return.
+ */
+static void runtime_push_slot(runtime_T* runtime, value_T value) {
+    if (runtime->slots_size == runtime->slots_capacity) {
+        runtime->slots_capacity = runtime->slots_capacity ? runtime->slots_capacity * 2 : 64;
+        runtime->slots = realloc(
+            runtime->slots,
+            runtime->slots_capacity * sizeof(value_T)
+        );
+    }
+
+    runtime->slots[runtime->slots_size++] = value;
+}
+
+/**
+ * @brief Pushes a new frame for a call, doubling the capacity
+ *        of the frames when they are used up. Exits with a stack
+ *        overflow when the calls would nest deeper than allowed.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] fdef Pointer to the called function definition.
+ * @param[in] base Index of the first argument slot of the call.
+ * @return void Does not return.
+ */
+static void runtime_push_frame(runtime_T* runtime, AST_T* fdef, size_t base) {
+    if (runtime->frames_size >= runtime->max_depth) {
+        runtime_error(runtime, "Stack overflow, calls nested deeper than %zu", runtime->max_depth);
+    }
+
+    if (runtime->frames_size == runtime->frames_capacity) {
+        runtime->frames_capacity = runtime->frames_capacity ? runtime->frames_capacity * 2 : 16;
+        runtime->frames = realloc(
+            runtime->frames,
+            runtime->frames_capacity * sizeof(struct FRAME_STRUCT)
+        );
+    }
+
+    frame_T* frame = &runtime->frames[runtime->frames_size++];
+    frame->fdef = fdef;
+    frame->base = base;
+}
+
+/* Arguments and result of the thread that runs a program, or calls
+   a function of it when there is a definition. */
+typedef struct RUNTIME_RUN_STRUCT
+{
+    runtime_T* runtime;
+    AST_T* root;
+    AST_T* fdef;
+    value_T* args;
+    size_t args_size;
+    value_T result;
+
+    /* Set when an error jumped out of the run. */
+    int failed;
+} runtime_run_T;
+
+static void runtime_enter(runtime_T* runtime, AST_T* fdef, size_t base);
+
+/**
+ * @brief Entry point of the thread that runs a program. A jump of the
+ *        host cannot cross threads, so errors jump back to this thread
+ *        first and are raised again once it has been joined.
+ * 
+ * @param[in] arg Pointer to the run struct.
+ * @return NULL Returns NULL, the result is stored in the run struct.
+ */
+static void* runtime_run_thread(void* arg) {
+    runtime_run_T* run = arg;
+    runtime_T* runtime = run->runtime;
+    jmp_buf* host = runtime->error.jump;
+    jmp_buf jump;
+
+    if (host != NULL) {
+        if (setjmp(jump) != 0) {
+            runtime->error.jump = host;
+            run->failed = 1;
+
+            return NULL;
+        }
+
+        runtime->error.jump = &jump;
+    }
+
+    if (run->fdef == NULL) {
+        run->result = runtime_visit(runtime, run->root);
+    } else {
+        AST_T* fdef = run->fdef;
+
+        if (run->args_size != fdef->fn_def_args_size) {
+            runtime_error(
+                runtime,
+                "Method `%s` expects %zu arguments, got %zu",
+                fdef->fn_def_name,
+                fdef->fn_def_args_size,
+                run->args_size
+            );
+        }
+
+        size_t base = runtime->slots_size;
+
+        for (size_t i = 0; i < run->args_size; i++) {
+            runtime_push_slot(runtime, run->args[i]);
+        }
+
+        runtime_enter(runtime, fdef, base);
+        run->result = VALUE_NIL;
+    }
+
+    runtime->error.jump = host;
+
+    return NULL;
+}
+
+/**
+ * @brief Maps the native stack of the tree walker, unless the stack
+ *        of an earlier run is large enough. Touched pages stay mapped,
+ *        so later runs neither map a stack nor fault in its pages.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return int Returns 1 when there is a stack, 0 if it cannot be mapped.
+ */
+static int runtime_map_stack(runtime_T* runtime) {
+    size_t guard = sysconf(_SC_PAGESIZE);
+    size_t size = guard + RUNTIME_BASE_STACK_SIZE + runtime->max_depth * RUNTIME_CALL_STACK_SIZE;
+
+    if (runtime->stack != NULL && runtime->stack_size >= size) {
+        return 1;
+    }
+
+    if (runtime->stack != NULL) {
+        munmap(runtime->stack, runtime->stack_size);
+        runtime->stack = NULL;
+    }
+
+    void* stack = mmap(
+        NULL,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+        -1,
+        0
+    );
+
+    if (stack == MAP_FAILED) {
+        return 0;
+    }
+
+    // The stack grows down, into the guard page when it overflows.
+    mprotect(stack, guard, PROT_NONE);
+
+    runtime->stack = stack;
+    runtime->stack_size = size;
+
+    return 1;
+}
+
+/**
+ * @brief Runs the thread of a run on a stack sized for the deepest
+ *        calls the runtime allows.
+ * 
+ * @param[in] run Pointer to the run struct.
+ * @return value Returns the result of the run.
+ */
+static value_T runtime_run_on_thread(runtime_run_T* run) {
+    runtime_T* runtime = run->runtime;
+    size_t guard = sysconf(_SC_PAGESIZE);
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    if (!runtime_map_stack(runtime)) {
+        runtime_error(runtime, "Could not allocate a stack for %zu nested calls", runtime->max_depth);
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(
+        &attr,
+        (char*) runtime->stack + guard,
+        runtime->stack_size - guard
+    );
+
+    runtime->stack_limit = (char*) runtime->stack + guard + RUNTIME_STACK_MARGIN;
+
+    if (pthread_create(&thread, &attr, runtime_run_thread, run) != 0) {
+        pthread_attr_destroy(&attr);
+        runtime->stack_limit = NULL;
+        runtime_error(runtime, "Could not allocate a stack for %zu nested calls", runtime->max_depth);
+    }
+
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+    runtime->stack_limit = NULL;
+
+    if (run->failed) {
+        error_raise(&runtime->error, 1);
+    }
+
+    return run->result;
+}
+
+/**
+ * @brief Runs a resolved program on the tree walker. The walker nests
+ *        on the native stack, so it runs on a thread whose stack is
+ *        sized for the deepest calls the runtime allows, rather than
+ *        on a stack limited by `ulimit -s`.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] root Pointer to the root node of the program.
+ * @return value Returns the value of the program.
+ */
+value_T runtime_run(runtime_T* runtime, AST_T* root) {
+    runtime_run_T run = { runtime, root, NULL, NULL, 0, VALUE_NIL, 0 };
+
+    return runtime_run_on_thread(&run);
+}
+
+/**
+ * @brief Calls a function of the program with argument values on the
+ *        tree walker, on a thread like runtime_run.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] fdef Pointer to the function definition.
+ * @param[in] args Values of the arguments.
+ * @param[in] args_size Amount of arguments.
+ * @return value Returns the value of the call.
+ */
+value_T runtime_call(runtime_T* runtime, AST_T* fdef, value_T* args, size_t args_size) {
+    runtime_run_T run = { runtime, NULL, fdef, args, args_size, VALUE_NIL, 0 };
+
+    return runtime_run_on_thread(&run);
+}
+
 /**
  * @brief Ensures that when the runtime visits a node that the
  *        appropriate action is taken depending on node type.
+ *        The node must have been resolved.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit(runtime_T* runtime, AST_T* node) {
+value_T runtime_visit(runtime_T* runtime, AST_T* node) {
+    // How deep a call nests depends on the expressions around it, so
+    // the stack is checked rather than the amount of calls alone.
+    if ((char*) __builtin_frame_address(0) < runtime->stack_limit) {
+        runtime_error(runtime, "Stack overflow, calls nested deeper than the stack allows");
+    }
+
     switch (node->type) {
         case AST_VARIABLE_DEFINITION: {
             return runtime_visit_var_def(runtime, node);
@@ -67,141 +557,354 @@ AST_T* runtime_visit(runtime_T* runtime, AST_T* node) {
         case AST_STRING: {
             return runtime_visit_string(runtime, node);
         }
+        case AST_INTEGER: {
+            return value_int(node->integer_value);
+        }
+        case AST_FLOAT: {
+            return value_double(node->float_value);
+        }
+        case AST_BOOLEAN: {
+            return value_bool(node->boolean_value);
+        }
+        case AST_BINARY: {
+            return runtime_visit_binary(runtime, node);
+        }
+        case AST_NEGATE: {
+            return runtime_visit_negate(runtime, node);
+        }
         case AST_COMPOUND: {
             return runtime_visit_compound(runtime, node);
         }
         case AST_NOOP: {
-            return node;
+            return VALUE_NIL;
         }
     }
 
-    printf("Uncaught statement of type `%d`\n", node->type);
-    exit(EXIT_FAILURE);
-
-    return init_ast(AST_NOOP);
+    runtime_error(runtime, "Uncaught statement of type `%d`", node->type);
 }
 
 /**
- * @brief Adds the variable definition to global scope
+ * @brief Evaluates the value of the variable definition once
+ *        and stores it in its global.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_var_def(runtime_T* runtime, AST_T* node) {
-    scope_add_var_def(
-        node->scope,
-        node        
-    ); 
+value_T runtime_visit_var_def(runtime_T* runtime, AST_T* node) {
+    runtime->globals.values[node->var_def_index] = runtime_visit(runtime, node->var_def_value);
 
-    return node;
+    return VALUE_NIL;
 }
 
 /**
- * @brief Adds the function definition to global scope
+ * @brief Binds the function definition to its global, invalidating
+ *        the call site caches when it replaces another definition.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_fn_def(runtime_T* runtime, AST_T* node) {
-    scope_add_fn_def(
-        node->scope,
-        node        
-    );
+value_T runtime_visit_fn_def(runtime_T* runtime, AST_T* node) {
+    value_T* function = &runtime->functions.values[node->fn_def_index];
+
+    if (*function != VALUE_UNDEFINED && *function != value_function(node)) {
+        runtime->functions_version += 1;
+    }
 
-    return node;
+    *function = value_function(node);
+
+    return VALUE_NIL;
 }
 
 /**
- * @brief Adds the variable name to global scope
+ * @brief Reads the variable from its argument slot in the active
+ *        call or from its global.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_var(runtime_T* runtime, AST_T* node) {
-    AST_T* vdef = scope_get_var_def(
-        node->scope,
-        node->var_name
-    );
-    
-    if (vdef != NULL) {
-        return runtime_visit(runtime, vdef->var_def_value);
+value_T runtime_visit_var(runtime_T* runtime, AST_T* node) {
+    if (node->var_local) {
+        frame_T* frame = &runtime->frames[runtime->frames_size - 1];
+
+        return runtime->slots[frame->base + node->var_index];
+    }
+
+    value_T value = runtime->globals.values[node->var_index];
+
+    // Defined, but the definition has not run yet.
+    if (value == VALUE_UNDEFINED) {
+        runtime_error(runtime, "Undefined var `%s`", node->var_name);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Finds the definition a call runs and checks that it is
+ *        defined and takes the arguments of the call.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the call node.
+ * @return fdef Returns the function definition.
+ */
+static AST_T* runtime_lookup_fn_call(runtime_T* runtime, AST_T* node) {
+    value_T function = runtime->functions.values[node->fn_call_index];
+
+    if (function == VALUE_UNDEFINED) {
+        runtime_error(runtime, "Undefined method `%s`", node->fn_call_name);
+    }
+
+    AST_T* fdef = (AST_T*) value_as_function(function);
+
+    if (node->fn_call_args_size != fdef->fn_def_args_size) {
+        runtime_error(
+            runtime,
+            "Method `%s` expects %zu arguments, got %zu",
+            node->fn_call_name,
+            fdef->fn_def_args_size,
+            node->fn_call_args_size
+        );
+    }
+
+    return fdef;
+}
+
+/**
+ * @brief Gives the definition a call runs, from the inline cache of
+ *        the call site while no function has been redefined.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the call node.
+ * @return fdef Returns the function definition.
+ */
+static AST_T* runtime_fn_call_target(runtime_T* runtime, AST_T* node) {
+    if (node->fn_call_version != runtime->functions_version) {
+        node->fn_call_fdef = runtime_lookup_fn_call(runtime, node);
+        node->fn_call_version = runtime->functions_version;
+    }
+
+    return node->fn_call_fdef;
+}
+
+/**
+ * @brief Gives the call in tail position of a function body. That is
+ *        a call of a function of the program which is the last
+ *        statement apart from empty ones, its value is nil like the
+ *        value of the body.
+ * 
+ * @param[in] body Pointer to the compound of the function body.
+ * @param[out] size Amount of statements before the call, or of all
+ *             statements if there is no call in tail position.
+ * @return call Returns the call node, or NULL if there is none.
+ */
+AST_T* runtime_tail_call(AST_T* body, size_t* size) {
+    size_t last = body->compound_size;
+
+    while (last > 0 && body->compound_value[last - 1]->type == AST_NOOP) {
+        last--;
     }
 
-    printf("Undefined var `%s`\n", node->var_name);
-    exit(EXIT_FAILURE);
+    *size = body->compound_size;
+
+    if (last == 0) {
+        return NULL;
+    }
+
+    AST_T* call = body->compound_value[last - 1];
+
+    if (call->type != AST_FUNCTION_CALL || call->fn_call_builtin) {
+        return NULL;
+    }
+
+    *size = last - 1;
+    return call;
 }
 
 /**
- * @brief Adds the function name to global scope
+ * @brief Binds the arguments from the base slot on to a new frame and
+ *        visits the function body in that frame. A call in tail
+ *        position of the body takes over the frame instead of nesting
+ *        another one. The frame and its slots are released when the
+ *        body returns.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] fdef Pointer to the called function definition.
+ * @param[in] base Index of the first argument slot of the call.
+ * @return void Does not return.
+ */
+static void runtime_enter(runtime_T* runtime, AST_T* fdef, size_t base) {
+    if (runtime->profiler != NULL) {
+        profiler_enter(runtime->profiler, fdef, fdef->fn_def_name);
+    }
+
+    for (;;) {
+        runtime_push_frame(runtime, fdef, base);
+
+        AST_T* body = fdef->fn_def_body;
+        size_t size;
+        AST_T* tail = runtime_tail_call(body, &size);
+
+        for (size_t i = 0; i < size; i++) {
+            runtime_visit(runtime, body->compound_value[i]);
+        }
+
+        if (tail == NULL) {
+            break;
+        }
+
+        // The tail call takes over the frame of this call. Its arguments
+        // are evaluated in this frame and then moved down to its base.
+        fdef = runtime_fn_call_target(runtime, tail);
+        size_t args = runtime->slots_size;
+
+        for (size_t i = 0; i < tail->fn_call_args_size; i++) {
+            runtime_push_slot(runtime, runtime_visit(runtime, tail->fn_call_args[i]));
+        }
+
+        if (tail->fn_call_args_size > 0) {
+            memmove(
+                runtime->slots + base,
+                runtime->slots + args,
+                tail->fn_call_args_size * sizeof(value_T)
+            );
+        }
+        runtime->slots_size = base + tail->fn_call_args_size;
+        runtime->frames_size -= 1;
+
+        if (runtime->profiler != NULL) {
+            profiler_tail(runtime->profiler, fdef, fdef->fn_def_name);
+        }
+    }
+
+    if (runtime->profiler != NULL) {
+        profiler_exit(runtime->profiler);
+    }
+
+    runtime->frames_size -= 1;
+    runtime->slots_size = base;
+}
+
+/**
+ * @brief Evaluates the arguments of the call, binds them to the slots
+ *        of a new frame and visits the function body in that frame.
+ *        The frame and its slots are released when the body returns.
+ *        A call in tail position of the body takes over the frame
+ *        instead of nesting another one. The checked definition is
+ *        cached at the call site until a function is redefined.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_fn_call(runtime_T* runtime, AST_T* node) {
-    if (strcmp(node->fn_call_name, "print") == 0) {
-        return builtin_fn_print(runtime, node->fn_call_args, node->fn_call_args_size);
+value_T runtime_visit_fn_call(runtime_T* runtime, AST_T* node) {
+    if (node->fn_call_builtin) {
+        return runtime_call_builtin(runtime, node);
     }
 
-    AST_T* fdef = scope_get_fn_def(
-        node->scope,
-        node->fn_call_name
-    );
+    // The arguments are evaluated in the frame of the caller,
+    // before the frame of the callee becomes the active one.
+    AST_T* fdef = runtime_fn_call_target(runtime, node);
+    size_t base = runtime->slots_size;
 
-    if (fdef == NULL) {
-        printf("Undefined method `%s`\n", node->fn_call_name);
-        exit(1);
+    for (size_t i = 0; i < node->fn_call_args_size; i++) {
+        runtime_push_slot(runtime, runtime_visit(runtime, node->fn_call_args[i]));
     }
 
-    for (int i = 0; i < (int) node->fn_call_args_size; i++) {
-        // grab the var from the fn def args
-        AST_T* ast_var = (AST_T*) fdef->fn_def_args[i];
+    runtime_enter(runtime, fdef, base);
+
+    // Bodies are compounds, which have no value.
+    return VALUE_NIL;
+}
+
+/**
+ * @brief Evaluates the arguments of the call and passes their values
+ *        to the builtin the call is bound to.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return value Returns the value of the node.
+ */
+value_T runtime_call_builtin(runtime_T* runtime, AST_T* node) {
+    size_t base = runtime->slots_size;
+
+    for (size_t i = 0; i < node->fn_call_args_size; i++) {
+        runtime_push_slot(runtime, runtime_visit(runtime, node->fn_call_args[i]));
+    }
+
+    builtin_T* builtin = &runtime->builtins.entries[node->fn_call_index];
+    value_T result = builtin->fn(runtime, runtime->slots + base, node->fn_call_args_size);
+
+    runtime->slots_size = base;
 
-        // grab the value from the fn call args
-        AST_T* ast_value = (AST_T*) node->fn_call_args[i];
+    return result;
+}
 
-        // consumee a new var def with the value of the argument
-        // in the fn call.
-        AST_T* ast_vardef = init_ast(AST_VARIABLE_DEFINITION);
-        ast_vardef->var_def_value = ast_value;
+/**
+ * @brief Gives the interned string of the string literal.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return value Returns the value of the node.
+ */
+value_T runtime_visit_string(runtime_T* runtime, AST_T* node) {
+    (void) runtime;
 
-        // copy the name from the fn def argument into the new
-        // var def
-        ast_vardef->var_def_var_name = (char*) calloc(strlen(ast_var->var_name) + 1, sizeof(char));
-        strcpy(ast_vardef->var_def_var_name, ast_var->var_name);
+    return value_string(node->string_value);
+}
 
-        // push our var def into the fn body scope.
-        scope_add_var_def(fdef->fn_def_body->scope, ast_vardef);
+/**
+ * @brief Applies the operator to the values of both operands.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return value Returns the value of the node.
+ */
+value_T runtime_visit_binary(runtime_T* runtime, AST_T* node) {
+    value_T left = runtime_visit(runtime, node->binary_left);
+    value_T right = runtime_visit(runtime, node->binary_right);
+    value_T result;
+    value_status_T status = value_binary(node->binary_op, left, right, &result);
+
+    if (status != VALUE_OK) {
+        runtime_error_operation(runtime, value_op_names[node->binary_op], status);
     }
-    
-    return runtime_visit(runtime, fdef->fn_def_body);
+
+    return result;
 }
 
 /**
- * @brief Gives abstract syntax tree on of type String.
+ * @brief Negates the value of the operand.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_string(runtime_T* runtime, AST_T* node) {
-    return node;
+value_T runtime_visit_negate(runtime_T* runtime, AST_T* node) {
+    value_T result;
+    value_status_T status = value_negate(runtime_visit(runtime, node->negate_value), &result);
+
+    if (status != VALUE_OK) {
+        runtime_error_operation(runtime, "-", status);
+    }
+
+    return result;
 }
 
 /**
- * @brief Gives abstract syntax tree on of type Compound.
+ * @brief Visits every statement of the compound, which has no
+ *        value of its own.
  * 
  * @param[in] runtime Pointer to the runtime struct.
  * @param[in] node Pointer to the visited node in the AST.
- * @return parser Returns abstract syntax tree node of proper type.
+ * @return value Returns the value of the node.
  */
-AST_T* runtime_visit_compound(runtime_T* runtime, AST_T* node) {
-    for (int i = 0; i < node->compound_size; i++) {
+value_T runtime_visit_compound(runtime_T* runtime, AST_T* node) {
+    for (size_t i = 0; i < node->compound_size; i++) {
         runtime_visit(runtime, node->compound_value[i]);
     }
 
-    return init_ast(AST_NOOP);
+    return VALUE_NIL;
 }
@@ -1,47 +1,113 @@
 #include "include/scope.h"
-#include <string.h>
+#include <stdint.h>
+
+#define SCOPE_TABLE_CAPACITY 16
 
 /**
  * @brief Initializes and allocates the scope struct 
  *        by setting the values to either NULL or 0.
  * 
- * @param[in] NONE
+ * @param[in] arena Pointer to the arena the scope is allocated from.
  * @return scope Returns newly allocated scope.
  */
-scope_T* init_scope() {
-    scope_T* scope = calloc(1, sizeof(struct SCOPE_STRUCT));
+scope_T* init_scope(arena_T* arena) {
+    scope_T* scope = arena_alloc(arena, sizeof(struct SCOPE_STRUCT));
+    scope->arena = arena;
 
-    scope->fn_defs = NULL;
-    scope->fn_defs_size = 0;
+    scope->fn_defs.entries = NULL;
+    scope->fn_defs.size = 0;
+    scope->fn_defs.capacity = 0;
 
-    scope->var_defs = NULL;
-    scope->var_defs_size = 0;
+    scope->var_defs.entries = NULL;
+    scope->var_defs.size = 0;
+    scope->var_defs.capacity = 0;
 
     return scope;
 }
 
 /**
- * @brief Adds a function definition to global scope.
+ * @brief Finds the slot of a name in a table. Names are interned,
+ *        so the pointer itself is hashed and compared.
+ * 
+ * @param[in] entries Entries of the table.
+ * @param[in] capacity Capacity of the table, a power of two.
+ * @param[in] name Interned string of the name.
+ * @return entry Returns the entry holding the name, or the
+ *         empty entry where it belongs.
+ */
+static scope_entry_T* scope_table_find(scope_entry_T* entries, size_t capacity, const char* name) {
+    size_t i = (size_t) (((uintptr_t) name >> 3) * 11400714819323198485ULL) & (capacity - 1);
+
+    while (entries[i].name != NULL && entries[i].name != name) {
+        i = (i + 1) & (capacity - 1);
+    }
+
+    return &entries[i];
+}
+
+/**
+ * @brief Sets the definition of a name in a table, doubling the
+ *        capacity when the table would become more than half full.
+ * 
+ * @param[in] scope Pointer to the scope struct.
+ * @param[in] table Pointer to the table.
+ * @param[in] name Interned string of the name.
+ * @param[in] def Pointer to the definition node.
+ * @return void Does not return.
+ */
+static void scope_table_put(scope_T* scope, scope_table_T* table, const char* name, AST_T* def) {
+    if ((table->size + 1) * 2 > table->capacity) {
+        scope_entry_T* entries = table->entries;
+        size_t capacity = table->capacity;
+
+        table->capacity = capacity ? capacity * 2 : SCOPE_TABLE_CAPACITY;
+        table->entries = arena_alloc(
+            scope->arena,
+            table->capacity * sizeof(struct SCOPE_ENTRY_STRUCT)
+        );
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (entries[i].name != NULL) {
+                *scope_table_find(table->entries, table->capacity, entries[i].name) = entries[i];
+            }
+        }
+    }
+
+    scope_entry_T* entry = scope_table_find(table->entries, table->capacity, name);
+
+    if (entry->name == NULL) {
+        entry->name = name;
+        table->size += 1;
+    }
+
+    entry->def = def;
+}
+
+/**
+ * @brief Looks up the definition of a name in a table.
+ * 
+ * @param[in] table Pointer to the table.
+ * @param[in] name Interned string of the name.
+ * @return def Returns the definition node or NULL if not found.
+ */
+static AST_T* scope_table_get(scope_table_T* table, const char* name) {
+    if (table->size == 0) {
+        return NULL;
+    }
+
+    return scope_table_find(table->entries, table->capacity, name)->def;
+}
+
+/**
+ * @brief Adds a function definition to global scope. A later
+ *        definition with the same name replaces the earlier one.
  * 
  * @param[in] scope Pointer to the scope struct.
  * @param[in] fdef Pointer to node for current function definition.
  * @return fdef Updates scope for function definition node.
  */
 AST_T* scope_add_fn_def(scope_T* scope, AST_T* fdef) {
-    scope->fn_defs_size += 1;
-
-    if (scope->fn_defs == NULL) {
-        scope->fn_defs = calloc(1, sizeof(struct AST_STRUCT*));
-    } else {
-        scope->fn_defs =
-            realloc(
-                scope->fn_defs,
-                scope->fn_defs_size * sizeof(struct AST_STRUCT**)
-            );
-    }
-
-    scope->fn_defs[scope->fn_defs_size-1] =
-        fdef;
+    scope_table_put(scope, &scope->fn_defs, fdef->fn_def_name, fdef);
 
     return fdef;
 }
@@ -51,42 +117,24 @@ AST_T* scope_add_fn_def(scope_T* scope, AST_T* fdef) {
  *        global scope by name.
  * 
  * @param[in] scope Pointer to the scope struct.
- * @param[in] fname String of function name.
+ * @param[in] fname Interned string of function name.
  * @return fdef Returns function definition node if found 
  *         in global scope or NULL if not found.
  */
 AST_T* scope_get_fn_def(scope_T* scope, const char* fname) {
-    for (int i = 0; i < scope->fn_defs_size; i++) {
-        AST_T* fdef = scope->fn_defs[i];
-
-        if (strcmp(fdef->fn_def_name, fname) == 0) {
-            return fdef;
-        }
-    }
-
-    return NULL;
+    return scope_table_get(&scope->fn_defs, fname);
 }
 
 /**
- * @brief Adds a variable definition to global scope.
+ * @brief Adds a variable definition to global scope. A later
+ *        definition with the same name replaces the earlier one.
  * 
  * @param[in] scope Pointer to the scope struct.
  * @param[in] vdef Pointer to node for current variable definition.
  * @return fdef Updates scope for variable definition node.
  */
 AST_T* scope_add_var_def(scope_T* scope, AST_T* vdef) {
-    if (scope->var_defs == NULL) {
-        scope->var_defs = calloc(1, sizeof(struct AST_STRUCT*));
-        scope->var_defs[0] = vdef;
-        scope->var_defs_size += 1;
-    } else {
-        scope->var_defs_size += 1;
-        scope->var_defs = realloc(
-            scope->var_defs,
-            scope->var_defs_size * sizeof(struct AST_STRUCT*)  
-        );
-        scope->var_defs[scope->var_defs_size-1] = vdef;
-    }
+    scope_table_put(scope, &scope->var_defs, vdef->var_def_var_name, vdef);
 
     return vdef;
 }
@@ -96,18 +144,10 @@ AST_T* scope_add_var_def(scope_T* scope, AST_T* vdef) {
  *        global scope by name.
  * 
  * @param[in] scope Pointer to the scope struct.
- * @param[in] name String of variable name.
+ * @param[in] name Interned string of variable name.
  * @return vdef Returns variable definition node if found 
  *         in global scope or NULL if not found.
  */
 AST_T* scope_get_var_def(scope_T* scope, const char* name) {
-    for (int i = 0; i < scope->var_defs_size; i++) {
-        AST_T* vdef = scope->var_defs[i];
-
-        if (strcmp(vdef->var_def_var_name, name) == 0) {
-            return vdef;
-        }
-    }
-
-    return NULL;
+    return scope_table_get(&scope->var_defs, name);
 }
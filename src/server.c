@@ -0,0 +1,450 @@
+#include "include/server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/* Most bytes of output relayed in one frame. */
+#define SERVER_CHUNK 65536
+
+/* Path of the program a worker runs, it lives as long as the worker. */
+static char server_filename[PATH_MAX];
+
+/**
+ * @brief Reads exactly a size from a file descriptor.
+ *
+ * @param[in] fd File descriptor to read from.
+ * @param[out] data Buffer to read into.
+ * @param[in] size Amount of bytes to read.
+ * @return int Returns 1 when every byte was read, 0 on end of file
+ *         or an error.
+ */
+static int server_read_all(int fd, void* data, size_t size) {
+    char* bytes = data;
+
+    while (size > 0) {
+        ssize_t length = read(fd, bytes, size);
+
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (length <= 0) {
+            return 0;
+        }
+
+        bytes += length;
+        size -= length;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Writes exactly a size to a file descriptor.
+ *
+ * @param[in] fd File descriptor to write to.
+ * @param[in] data Bytes to write.
+ * @param[in] size Amount of bytes to write.
+ * @return int Returns 1 when every byte was written, 0 on an error.
+ */
+static int server_write_all(int fd, const void* data, size_t size) {
+    const char* bytes = data;
+
+    while (size > 0) {
+        ssize_t length = write(fd, bytes, size);
+
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (length <= 0) {
+            return 0;
+        }
+
+        bytes += length;
+        size -= length;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Writes a frame.
+ *
+ * @param[in] fd File descriptor to write to.
+ * @param[in] type Type of the frame.
+ * @param[in] data Payload of the frame.
+ * @param[in] length Amount of bytes in the payload.
+ * @return int Returns 1 when the frame was written, 0 on an error.
+ */
+static int server_write_frame(int fd, server_frame_T type, const void* data, uint32_t length) {
+    char header[5];
+    header[0] = type;
+    memcpy(header + 1, &length, sizeof(length));
+
+    return server_write_all(fd, header, sizeof(header))
+        && server_write_all(fd, data, length);
+}
+
+/**
+ * @brief Reads the type and length of a frame.
+ *
+ * @param[in] fd File descriptor to read from.
+ * @param[out] type Type of the frame.
+ * @param[out] length Amount of bytes in the payload.
+ * @return int Returns 1 when the header was read, 0 on end of file
+ *         or an error.
+ */
+static int server_read_header(int fd, server_frame_T* type, uint32_t* length) {
+    unsigned char header[5];
+
+    if (!server_read_all(fd, header, sizeof(header))) {
+        return 0;
+    }
+
+    *type = header[0];
+    memcpy(length, header + 1, sizeof(*length));
+
+    return 1;
+}
+
+/**
+ * @brief Opens a Unix socket.
+ *
+ * @param[in] path Path of the socket.
+ * @param[out] address Address of the socket.
+ * @return fd Returns the socket, or -1 when it cannot be opened.
+ */
+static int server_socket(const char* path, struct sockaddr_un* address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(address->sun_path)) {
+        return -1;
+    }
+
+    strcpy(address->sun_path, path);
+
+    return socket(AF_UNIX, SOCK_STREAM, 0);
+}
+
+/**
+ * @brief Sends what a program writes to the client, until the program
+ *        closes its standard output and error.
+ *
+ * @param[in] client Connection to the client.
+ * @param[in] out Read end of the standard output of the program.
+ * @param[in] err Read end of the standard error of the program.
+ * @return int Returns 1 when everything was sent, 0 when the client
+ *         went away.
+ */
+static int server_relay(int client, int out, int err) {
+    struct pollfd fds[2] = { { out, POLLIN, 0 }, { err, POLLIN, 0 } };
+    server_frame_T types[2] = { SERVER_STDOUT, SERVER_STDERR };
+    char* buffer = malloc(SERVER_CHUNK);
+    int open = 2;
+
+    while (open > 0) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+
+        for (size_t i = 0; i < 2; i++) {
+            if (fds[i].fd < 0 || fds[i].revents == 0) {
+                continue;
+            }
+
+            ssize_t length = read(fds[i].fd, buffer, SERVER_CHUNK);
+
+            if (length < 0 && errno == EINTR) {
+                continue;
+            }
+
+            // Negative descriptors are left out by poll.
+            if (length <= 0) {
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                open -= 1;
+            } else if (!server_write_frame(client, types[i], buffer, length)) {
+                free(buffer);
+                return 0;
+            }
+        }
+    }
+
+    free(buffer);
+
+    return 1;
+}
+
+/**
+ * @brief Handles a connection: reads the request, starts the copy
+ *        that runs the program and sends its output and exit status.
+ *
+ * @param[in] client Connection to the client.
+ * @param[out] filename Path of the program, or NULL when its source
+ *             was sent.
+ * @return source Returns only in the copy that runs the program, see
+ *         server_serve.
+ */
+static source_T* server_handle(int client, const char** filename) {
+    server_frame_T type;
+    uint32_t length;
+
+    // The program is waited for, unlike the handlers of the server.
+    signal(SIGCHLD, SIG_DFL);
+
+    if (!server_read_header(client, &type, &length)
+            || (type != SERVER_PATH && type != SERVER_SOURCE)
+            || (type == SERVER_PATH && length >= PATH_MAX)
+            || length > SERVER_MAX_REQUEST) {
+        _exit(1);
+    }
+
+    char* payload = malloc(length + 1);
+
+    if (!server_read_all(client, payload, length)) {
+        _exit(1);
+    }
+
+    payload[length] = '\0';
+
+    int out[2];
+    int err[2];
+
+    if (pipe(out) != 0 || pipe(err) != 0) {
+        _exit(1);
+    }
+
+    pid_t worker = fork();
+
+    if (worker < 0) {
+        _exit(1);
+    }
+
+    if (worker == 0) {
+        signal(SIGPIPE, SIG_DFL);
+        dup2(out[1], STDOUT_FILENO);
+        dup2(err[1], STDERR_FILENO);
+        close(out[0]);
+        close(out[1]);
+        close(err[0]);
+        close(err[1]);
+        close(client);
+
+        if (type == SERVER_PATH) {
+            snprintf(server_filename, sizeof(server_filename), "%s", payload);
+            *filename = server_filename;
+            free(payload);
+
+            return NULL;
+        }
+
+        source_T* source = calloc(1, sizeof(struct SOURCE_STRUCT));
+        source->contents = payload;
+        source->length = length;
+        *filename = NULL;
+
+        return source;
+    }
+
+    close(out[1]);
+    close(err[1]);
+
+    if (!server_relay(client, out[0], err[0])) {
+        kill(worker, SIGKILL);
+    }
+
+    int status;
+
+    while (waitpid(worker, &status, 0) < 0 && errno == EINTR) {
+    }
+
+    uint32_t code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    server_write_frame(client, SERVER_EXIT, &code, sizeof(code));
+
+    _exit(0);
+}
+
+/**
+ * @brief Serves programs sent over a Unix socket. Every connection is
+ *        handled by a copy of the process as it was started, with any
+ *        image already restored, and the program runs in a copy of
+ *        that, so no state is left over from earlier requests. The
+ *        server only returns in the copies that run a program, with
+ *        their output going to the client.
+ *
+ * @param[in] path Path of the socket.
+ * @param[out] filename Path of the program, or NULL when its source
+ *             was sent.
+ * @return source Returns the source of the program when it was sent,
+ *         NULL when the program is to be read from its path.
+ */
+source_T* server_serve(const char* path, const char** filename) {
+    struct sockaddr_un address;
+    int listener = server_socket(path, &address);
+
+    // A socket left behind by an earlier server is replaced, but
+    // nothing else is.
+    struct stat info;
+
+    if (lstat(path, &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            printf("Could not listen on `%s`, it exists and is not a socket\n", path);
+            exit(1);
+        }
+
+        unlink(path);
+    }
+
+    if (listener < 0
+            || bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0
+            || listen(listener, SOMAXCONN) != 0) {
+        printf("Could not listen on `%s`\n", path);
+        exit(1);
+    }
+
+    // Handlers are reaped as they exit, and one whose client went away
+    // sees an error instead of being killed.
+    signal(SIGCHLD, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+    fflush(stdout);
+
+    for (;;) {
+        int client = accept(listener, NULL, NULL);
+
+        if (client < 0) {
+            continue;
+        }
+
+        pid_t handler = fork();
+
+        if (handler == 0) {
+            close(listener);
+
+            return server_handle(client, filename);
+        }
+
+        close(client);
+    }
+}
+
+/**
+ * @brief Reads the whole standard input.
+ *
+ * @param[out] length Amount of bytes read.
+ * @return contents Returns the newly allocated bytes.
+ */
+static char* server_read_stdin(size_t* length) {
+    size_t capacity = SERVER_CHUNK;
+    char* contents = malloc(capacity);
+    ssize_t read_length;
+
+    *length = 0;
+
+    while ((read_length = read(STDIN_FILENO, contents + *length, capacity - *length)) != 0) {
+        if (read_length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            printf("Could not read the standard input\n");
+            exit(1);
+        }
+
+        *length += read_length;
+
+        if (*length == capacity) {
+            capacity *= 2;
+            contents = realloc(contents, capacity);
+        }
+    }
+
+    return contents;
+}
+
+/**
+ * @brief Sends a program to a server and writes what it prints to
+ *        the standard output and error.
+ *
+ * @param[in] path Path of the socket.
+ * @param[in] filename Path of the program, or "-" to send the source
+ *            read from the standard input.
+ * @return status Returns the exit status of the program.
+ */
+int server_connect(const char* path, const char* filename) {
+    struct sockaddr_un address;
+    int server = server_socket(path, &address);
+
+    if (server < 0 || connect(server, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        printf("Could not connect to `%s`\n", path);
+        exit(1);
+    }
+
+    int sent;
+
+    if (strcmp(filename, "-") == 0) {
+        size_t length;
+        char* contents = server_read_stdin(&length);
+
+        if (length > SERVER_MAX_REQUEST) {
+            printf("Program is larger than %u bytes\n", SERVER_MAX_REQUEST);
+            exit(1);
+        }
+
+        sent = server_write_frame(server, SERVER_SOURCE, contents, length);
+        free(contents);
+    } else {
+        // The server runs in a directory of its own.
+        char* resolved = realpath(filename, NULL);
+        const char* name = resolved != NULL ? resolved : filename;
+
+        sent = server_write_frame(server, SERVER_PATH, name, strlen(name));
+        free(resolved);
+    }
+
+    size_t capacity = SERVER_CHUNK;
+    char* buffer = malloc(capacity);
+    server_frame_T type;
+    uint32_t length;
+
+    while (sent && server_read_header(server, &type, &length)) {
+        if (length > capacity) {
+            capacity = length;
+            buffer = realloc(buffer, capacity);
+        }
+
+        if (!server_read_all(server, buffer, length)) {
+            break;
+        }
+
+        if (type == SERVER_STDOUT) {
+            server_write_all(STDOUT_FILENO, buffer, length);
+        } else if (type == SERVER_STDERR) {
+            server_write_all(STDERR_FILENO, buffer, length);
+        } else if (type == SERVER_EXIT && length == sizeof(uint32_t)) {
+            uint32_t status;
+            memcpy(&status, buffer, sizeof(status));
+            free(buffer);
+            close(server);
+
+            return status;
+        }
+    }
+
+    printf("Lost connection to `%s`\n", path);
+    exit(1);
+}
@@ -0,0 +1,353 @@
+#include "include/stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+
+static const char* const stats_phase_names[] = {
+    [STATS_IMAGE] = "image",
+    [STATS_READ] = "read",
+    [STATS_CACHE] = "cache",
+    [STATS_LEX] = "lex",
+    [STATS_PARSE] = "parse",
+    [STATS_RESOLVE] = "resolve",
+    [STATS_FOLD] = "fold",
+    [STATS_COMPILE] = "compile",
+    [STATS_RUN] = "run",
+};
+
+/**
+ * @brief Reads a clock.
+ *
+ * @param[in] clock Clock to read.
+ * @return seconds Returns the time of the clock in seconds.
+ */
+static double stats_clock(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Initializes and allocates the statistics of a run. Every
+ *        other stats function does nothing when given NULL instead,
+ *        so that a run without statistics pays nothing for them.
+ *
+ * @param[in] arena Pointer to the arena the phases allocate from.
+ * @param[in] format Format the statistics are printed in.
+ * @return stats Returns newly allocated statistics.
+ */
+stats_T* init_stats(arena_T* arena, stats_format_T format) {
+    // Not allocated from the arena, which it counts the allocations of.
+    stats_T* stats = calloc(1, sizeof(struct STATS_STRUCT));
+    stats->arena = arena;
+    stats->format = format;
+
+    return stats;
+}
+
+/**
+ * @brief Releases the statistics.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @return void Does not return.
+ */
+void stats_free(stats_T* stats) {
+    free(stats);
+}
+
+/**
+ * @brief Starts timing a phase.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @param[in] phase Phase that starts.
+ * @return void Does not return.
+ */
+void stats_begin(stats_T* stats, stats_phase_T phase) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->phase = phase;
+    stats->start.wall = stats_clock(CLOCK_MONOTONIC);
+    stats->start.cpu = stats_clock(CLOCK_PROCESS_CPUTIME_ID);
+    stats->start.allocations = stats->arena->allocations;
+    stats->start.allocated = stats->arena->allocated;
+}
+
+/**
+ * @brief Stops timing the phase that runs and adds its time and
+ *        allocations to those of the phase.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @return void Does not return.
+ */
+void stats_end(stats_T* stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats_phase_result_T* phase = &stats->phases[stats->phase];
+    phase->ran = 1;
+    phase->wall += stats_clock(CLOCK_MONOTONIC) - stats->start.wall;
+    phase->cpu += stats_clock(CLOCK_PROCESS_CPUTIME_ID) - stats->start.cpu;
+    phase->allocations += stats->arena->allocations - stats->start.allocations;
+    phase->allocated += stats->arena->allocated - stats->start.allocated;
+}
+
+/**
+ * @brief Counts the nodes of every type below a node.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @param[in] node Pointer to the visited node in the AST.
+ * @return void Does not return.
+ */
+void stats_count_nodes(stats_T* stats, AST_T* node) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->nodes[node->type]++;
+
+    switch (node->type) {
+        case AST_VARIABLE_DEFINITION: {
+            stats_count_nodes(stats, node->var_def_value);
+            break;
+        }
+        case AST_FUNCTION_DEFINITION: {
+            for (size_t i = 0; i < node->fn_def_args_size; i++) {
+                stats_count_nodes(stats, node->fn_def_args[i]);
+            }
+
+            stats_count_nodes(stats, node->fn_def_body);
+            break;
+        }
+        case AST_FUNCTION_CALL: {
+            for (size_t i = 0; i < node->fn_call_args_size; i++) {
+                stats_count_nodes(stats, node->fn_call_args[i]);
+            }
+
+            break;
+        }
+        case AST_BINARY: {
+            stats_count_nodes(stats, node->binary_left);
+            stats_count_nodes(stats, node->binary_right);
+            break;
+        }
+        case AST_NEGATE: {
+            stats_count_nodes(stats, node->negate_value);
+            break;
+        }
+        case AST_COMPOUND: {
+            for (size_t i = 0; i < node->compound_size; i++) {
+                stats_count_nodes(stats, node->compound_value[i]);
+            }
+
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Records the tokens of the lexer, the definitions of the
+ *        scope and the globals, functions and builtins of the runtime.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @param[in] lexer Pointer to the lexer struct.
+ * @param[in] scope Pointer to the parsed scope, or NULL if nothing
+ *            was parsed.
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return void Does not return.
+ */
+void stats_record(stats_T* stats, lexer_T* lexer, scope_T* scope, runtime_T* runtime) {
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->tokens = lexer->tokens;
+
+    if (scope != NULL) {
+        stats->scope_functions = scope->fn_defs.size;
+        stats->scope_variables = scope->var_defs.size;
+    }
+
+    stats->globals = runtime->globals.size;
+    stats->functions = runtime->functions.size;
+    stats->builtins = runtime->builtins.size;
+}
+
+/**
+ * @brief Gives the most memory the process has had resident.
+ *
+ * @param[in] NONE
+ * @return size Returns the peak resident set size in kilobytes.
+ */
+long stats_peak_rss() {
+    // The high water mark of the address space counts only this
+    // program, while getrusage also counts the process that spawned
+    // it, up to the exec.
+    FILE* status = fopen("/proc/self/status", "r");
+
+    if (status != NULL) {
+        char line[256];
+        long peak = -1;
+
+        while (fgets(line, sizeof(line), status) != NULL) {
+            if (sscanf(line, "VmHWM: %ld kB", &peak) == 1) {
+                break;
+            }
+        }
+
+        fclose(status);
+
+        if (peak >= 0) {
+            return peak;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Prints the statistics as JSON.
+ *
+ * @param[in] stats Pointer to the stats struct.
+ * @param[in] file File to print to.
+ * @return void Does not return.
+ */
+static void stats_print_json(stats_T* stats, FILE* file) {
+    fprintf(file, "{\n  \"phases\": {");
+
+    int first = 1;
+
+    for (size_t i = 0; i < STATS_PHASES; i++) {
+        stats_phase_result_T* phase = &stats->phases[i];
+
+        if (!phase->ran) {
+            continue;
+        }
+
+        fprintf(
+            file,
+            "%s\n    \"%s\": { \"wall_seconds\": %.9f, \"cpu_seconds\": %.9f,"
+            " \"allocations\": %zu, \"allocated_bytes\": %zu }",
+            first ? "" : ",",
+            stats_phase_names[i],
+            phase->wall,
+            phase->cpu,
+            phase->allocations,
+            phase->allocated
+        );
+        first = 0;
+    }
+
+    fprintf(file, "\n  },\n  \"tokens\": %zu,\n  \"nodes\": {", stats->tokens);
+
+    for (size_t i = 0; i < AST_TYPES; i++) {
+        fprintf(file, "%s\n    \"%s\": %zu", i ? "," : "", ast_type_names[i], stats->nodes[i]);
+    }
+
+    fprintf(
+        file,
+        "\n  },\n"
+        "  \"scope\": { \"functions\": %zu, \"variables\": %zu },\n"
+        "  \"globals\": %zu,\n"
+        "  \"functions\": %zu,\n"
+        "  \"builtins\": %zu,\n"
+        "  \"arena\": { \"allocations\": %zu, \"allocated_bytes\": %zu },\n"
+        "  \"peak_rss_kb\": %ld\n"
+        "}\n",
+        stats->scope_functions,
+        stats->scope_variables,
+        stats->globals,
+        stats->functions,
+        stats->builtins,
+        stats->arena->allocations,
+        stats->arena->allocated,
+        stats_peak_rss()
+    );
+}
+
+/**
+ * @brief Prints the statistics as text.
+ *
+ * @param[in] stats Pointer to the stats struct.
+ * @param[in] file File to print to.
+ * @return void Does not return.
+ */
+static void stats_print_text(stats_T* stats, FILE* file) {
+    fprintf(file, "%-10s %12s %12s %12s %14s\n", "phase", "wall ms", "cpu ms", "allocations", "bytes");
+
+    for (size_t i = 0; i < STATS_PHASES; i++) {
+        stats_phase_result_T* phase = &stats->phases[i];
+
+        if (!phase->ran) {
+            continue;
+        }
+
+        fprintf(
+            file,
+            "%-10s %12.3f %12.3f %12zu %14zu\n",
+            stats_phase_names[i],
+            phase->wall * 1e3,
+            phase->cpu * 1e3,
+            phase->allocations,
+            phase->allocated
+        );
+    }
+
+    fprintf(
+        file,
+        "%-10s %12s %12s %12zu %14zu\n",
+        "arena", "", "",
+        stats->arena->allocations,
+        stats->arena->allocated
+    );
+
+    fprintf(file, "\ntokens %zu\nnodes\n", stats->tokens);
+
+    for (size_t i = 0; i < AST_TYPES; i++) {
+        if (stats->nodes[i] > 0) {
+            fprintf(file, "  %-20s %10zu\n", ast_type_names[i], stats->nodes[i]);
+        }
+    }
+
+    fprintf(
+        file,
+        "scope %zu functions, %zu variables\n"
+        "runtime %zu globals, %zu functions, %zu builtins\n"
+        "peak rss %ld kB\n",
+        stats->scope_functions,
+        stats->scope_variables,
+        stats->globals,
+        stats->functions,
+        stats->builtins,
+        stats_peak_rss()
+    );
+}
+
+/**
+ * @brief Prints the statistics to stderr, so that they do not mix
+ *        with what the program prints.
+ *
+ * @param[in] stats Pointer to the stats struct, or NULL.
+ * @return void Does not return.
+ */
+void stats_print(stats_T* stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    if (stats->format == STATS_JSON) {
+        stats_print_json(stats, stderr);
+    } else {
+        stats_print_text(stats, stderr);
+    }
+}
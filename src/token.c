@@ -1,18 +1,22 @@
 #include "include/token.h"
-#include <stdlib.h>
 
 /**
  * @brief Initializes and allocates new token.
- *        Sets the type and value to the provided parameters 
+ *        Sets the type and the span in the lexer contents
+ *        to the provided parameters.
  * 
+ * @param[in] arena Pointer to the arena the token is allocated from.
  * @param[in] type Integer value of the type.
- * @param[in] value String of the value.
+ * @param[in] start Offset of the first character of the value.
+ * @param[in] length Amount of characters in the value.
  * @return token Returns newly allocated token.
  */
-token_T* init_token(int type, char* value) {
-    token_T* token = calloc(1, sizeof(struct TOKEN_STRUCT));
+token_T* init_token(arena_T* arena, int type, size_t start, size_t length) {
+    token_T* token = arena_alloc(arena, sizeof(struct TOKEN_STRUCT));
     token->type = type;
-    token->value = value;
+    token->start = start;
+    token->length = length;
+    token->value = NULL;
 
     return token;
 }
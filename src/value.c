@@ -0,0 +1,194 @@
+#include "include/value.h"
+#include <math.h>
+
+const char* const value_op_names[] = {
+    [VALUE_OP_ADD] = "+",
+    [VALUE_OP_SUB] = "-",
+    [VALUE_OP_MUL] = "*",
+    [VALUE_OP_DIV] = "/",
+    [VALUE_OP_MOD] = "%",
+    [VALUE_OP_EQUAL] = "==",
+    [VALUE_OP_NOT_EQUAL] = "!=",
+    [VALUE_OP_LESS] = "<",
+    [VALUE_OP_GREATER] = ">",
+    [VALUE_OP_LESS_EQUAL] = "<=",
+    [VALUE_OP_GREATER_EQUAL] = ">=",
+};
+
+/**
+ * @brief Reads a number as a double.
+ * 
+ * @param[in] value Value to read.
+ * @param[out] number The number, when the value is one.
+ * @return int Returns 1 when the value is a number, 0 otherwise.
+ */
+static int value_to_double(value_T value, double* number) {
+    if (value_is_int(value)) {
+        *number = value_as_int(value);
+        return 1;
+    }
+
+    if (value_is_double(value)) {
+        *number = value_as_double(value);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Applies an operator to two integers, falling back to doubles
+ *        when the result is not an integer that fits.
+ * 
+ * @param[in] op Operator to apply.
+ * @param[in] left Left operand.
+ * @param[in] right Right operand.
+ * @param[out] result Result of the operation, when it succeeds.
+ * @return status Returns VALUE_OK or why the operation failed.
+ */
+static value_status_T value_binary_int(value_op_T op, int32_t left, int32_t right, value_T* result) {
+    int32_t number;
+
+    switch (op) {
+        case VALUE_OP_ADD: {
+            if (__builtin_add_overflow(left, right, &number)) {
+                *result = value_double((double) left + right);
+            } else {
+                *result = value_int(number);
+            }
+            return VALUE_OK;
+        }
+        case VALUE_OP_SUB: {
+            if (__builtin_sub_overflow(left, right, &number)) {
+                *result = value_double((double) left - right);
+            } else {
+                *result = value_int(number);
+            }
+            return VALUE_OK;
+        }
+        case VALUE_OP_MUL: {
+            if (__builtin_mul_overflow(left, right, &number)) {
+                *result = value_double((double) left * right);
+            } else {
+                *result = value_int(number);
+            }
+            return VALUE_OK;
+        }
+        case VALUE_OP_DIV: {
+            if (right == 0) {
+                return VALUE_ERROR_DIVISION_BY_ZERO;
+            }
+
+            // INT32_MIN / -1 does not fit, so it is left to doubles too.
+            if (right != -1 && left % right == 0) {
+                *result = value_int(left / right);
+            } else {
+                *result = value_double((double) left / right);
+            }
+            return VALUE_OK;
+        }
+        case VALUE_OP_MOD: {
+            if (right == 0) {
+                return VALUE_ERROR_DIVISION_BY_ZERO;
+            }
+
+            *result = value_int(right == -1 ? 0 : left % right);
+            return VALUE_OK;
+        }
+        case VALUE_OP_EQUAL: *result = value_bool(left == right); return VALUE_OK;
+        case VALUE_OP_NOT_EQUAL: *result = value_bool(left != right); return VALUE_OK;
+        case VALUE_OP_LESS: *result = value_bool(left < right); return VALUE_OK;
+        case VALUE_OP_GREATER: *result = value_bool(left > right); return VALUE_OK;
+        case VALUE_OP_LESS_EQUAL: *result = value_bool(left <= right); return VALUE_OK;
+        case VALUE_OP_GREATER_EQUAL: *result = value_bool(left >= right); return VALUE_OK;
+    }
+
+    return VALUE_ERROR_TYPES;
+}
+
+/**
+ * @brief Applies an operator to two doubles.
+ * 
+ * @param[in] op Operator to apply.
+ * @param[in] left Left operand.
+ * @param[in] right Right operand.
+ * @param[out] result Result of the operation, when it succeeds.
+ * @return status Returns VALUE_OK or why the operation failed.
+ */
+static value_status_T value_binary_double(value_op_T op, double left, double right, value_T* result) {
+    switch (op) {
+        case VALUE_OP_ADD: *result = value_double(left + right); return VALUE_OK;
+        case VALUE_OP_SUB: *result = value_double(left - right); return VALUE_OK;
+        case VALUE_OP_MUL: *result = value_double(left * right); return VALUE_OK;
+        case VALUE_OP_DIV: *result = value_double(left / right); return VALUE_OK;
+        case VALUE_OP_MOD: *result = value_double(fmod(left, right)); return VALUE_OK;
+        case VALUE_OP_EQUAL: *result = value_bool(left == right); return VALUE_OK;
+        case VALUE_OP_NOT_EQUAL: *result = value_bool(left != right); return VALUE_OK;
+        case VALUE_OP_LESS: *result = value_bool(left < right); return VALUE_OK;
+        case VALUE_OP_GREATER: *result = value_bool(left > right); return VALUE_OK;
+        case VALUE_OP_LESS_EQUAL: *result = value_bool(left <= right); return VALUE_OK;
+        case VALUE_OP_GREATER_EQUAL: *result = value_bool(left >= right); return VALUE_OK;
+    }
+
+    return VALUE_ERROR_TYPES;
+}
+
+/**
+ * @brief Applies a binary operator. Integers stay integers unless the
+ *        result does not fit or a division is not exact, mixed operands
+ *        are computed as doubles. Every value can be compared for
+ *        equality, only numbers can be ordered.
+ * 
+ * @param[in] op Operator to apply.
+ * @param[in] left Left operand.
+ * @param[in] right Right operand.
+ * @param[out] result Result of the operation, when it succeeds.
+ * @return status Returns VALUE_OK or why the operation failed.
+ */
+value_status_T value_binary(value_op_T op, value_T left, value_T right, value_T* result) {
+    if (value_is_int(left) && value_is_int(right)) {
+        return value_binary_int(op, value_as_int(left), value_as_int(right), result);
+    }
+
+    double left_number;
+    double right_number;
+
+    if (value_to_double(left, &left_number) && value_to_double(right, &right_number)) {
+        return value_binary_double(op, left_number, right_number, result);
+    }
+
+    // Strings are interned, so equal strings are the same word.
+    if (op == VALUE_OP_EQUAL) {
+        *result = value_bool(left == right);
+        return VALUE_OK;
+    }
+
+    if (op == VALUE_OP_NOT_EQUAL) {
+        *result = value_bool(left != right);
+        return VALUE_OK;
+    }
+
+    return VALUE_ERROR_TYPES;
+}
+
+/**
+ * @brief Negates a number.
+ * 
+ * @param[in] value Operand.
+ * @param[out] result Negated number, when the operand is a number.
+ * @return status Returns VALUE_OK or why the operation failed.
+ */
+value_status_T value_negate(value_T value, value_T* result) {
+    if (value_is_int(value)) {
+        int32_t number = value_as_int(value);
+        *result = number == INT32_MIN ? value_double(-(double) number) : value_int(-number);
+        return VALUE_OK;
+    }
+
+    if (value_is_double(value)) {
+        *result = value_double(-value_as_double(value));
+        return VALUE_OK;
+    }
+
+    return VALUE_ERROR_TYPES;
+}
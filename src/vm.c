@@ -0,0 +1,388 @@
+#include "include/vm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Initializes and allocates the virtual machine.
+ * 
+ * @param[in] runtime Pointer to the runtime struct.
+ * @return vm Returns newly allocated virtual machine.
+ */
+vm_T* init_vm(runtime_T* runtime) {
+    vm_T* vm = calloc(1, sizeof(struct VM_STRUCT));
+    vm->runtime = runtime;
+    vm->functions_version = 1;
+
+    return vm;
+}
+
+/**
+ * @brief Releases the stacks and globals of the virtual machine.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @return void Does not return.
+ */
+void vm_free(vm_T* vm) {
+    free(vm->stack);
+    free(vm->frames);
+    free(vm->globals);
+    free(vm->functions);
+    free(vm);
+}
+
+/**
+ * @brief Grows the globals to every global the resolver has bound,
+ *        new globals start with the value the runtime has for them,
+ *        which is undefined unless it was restored from an image.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @return void Does not return.
+ */
+static void vm_bind_globals(vm_T* vm) {
+    size_t globals_size = vm->runtime->globals.size;
+    size_t functions_size = vm->runtime->functions.size;
+
+    if (globals_size > vm->globals_size) {
+        vm->globals = realloc(vm->globals, globals_size * sizeof(value_T));
+
+        for (size_t i = vm->globals_size; i < globals_size; i++) {
+            vm->globals[i] = vm->runtime->globals.values[i];
+        }
+
+        vm->globals_size = globals_size;
+    }
+
+    if (functions_size > vm->functions_size) {
+        vm->functions = realloc(vm->functions, functions_size * sizeof(struct CHUNK_FUNCTION_STRUCT*));
+        memset(vm->functions + vm->functions_size, 0, (functions_size - vm->functions_size) * sizeof(struct CHUNK_FUNCTION_STRUCT*));
+        vm->functions_size = functions_size;
+    }
+}
+
+/**
+ * @brief Makes room on the stack for every value a call of the
+ *        function whose arguments start at base puts on it.
+ *        The stack may move.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @param[in] function Pointer to the called function.
+ * @param[in] base Index of the first argument on the stack.
+ * @return void Does not return.
+ */
+static void vm_reserve_stack(vm_T* vm, chunk_function_T* function, size_t base) {
+    size_t needed = base + function->max_stack;
+
+    if (needed > vm->stack_capacity) {
+        size_t capacity = vm->stack_capacity ? vm->stack_capacity : 256;
+
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+
+        vm->stack = realloc(vm->stack, capacity * sizeof(value_T));
+        vm->stack_capacity = capacity;
+    }
+}
+
+/**
+ * @brief Pushes a frame for a call of the function whose arguments
+ *        start at base, and makes room for every value its code
+ *        puts on the stack. Exits with a stack overflow when the
+ *        calls would nest deeper than the runtime allows.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @param[in] function Pointer to the called function.
+ * @param[in] base Index of the first argument on the stack.
+ * @return frame Returns the new frame.
+ */
+static vm_frame_T* vm_push_frame(vm_T* vm, chunk_function_T* function, size_t base) {
+    // The frame of the top level is not a call.
+    if (vm->frames_size > vm->runtime->max_depth) {
+        runtime_error(vm->runtime, "Stack overflow, calls nested deeper than %zu", vm->runtime->max_depth);
+    }
+
+    if (vm->frames_size == vm->frames_capacity) {
+        vm->frames_capacity = vm->frames_capacity ? vm->frames_capacity * 2 : 64;
+        vm->frames = realloc(vm->frames, vm->frames_capacity * sizeof(struct VM_FRAME_STRUCT));
+    }
+
+    vm_reserve_stack(vm, function, base);
+
+    vm_frame_T* frame = &vm->frames[vm->frames_size++];
+    frame->function = function;
+    frame->ip = function->chunk->code + function->entry;
+    frame->base = base;
+
+    return frame;
+}
+
+/**
+ * @brief Finds the function a call runs and checks that it is
+ *        defined and takes the arguments of the call.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @param[in] global Index of the called function global.
+ * @param[in] argc Amount of arguments of the call.
+ * @return function Returns the called function.
+ */
+static chunk_function_T* vm_lookup_call(vm_T* vm, size_t global, size_t argc) {
+    chunk_function_T* function = vm->functions[global];
+
+    if (function == NULL) {
+        runtime_error(vm->runtime, "Undefined method `%s`", vm->runtime->functions.names[global]);
+    }
+
+    if (argc != function->arity) {
+        runtime_error(
+            vm->runtime,
+            "Method `%s` expects %zu arguments, got %zu",
+            function->name,
+            function->arity,
+            argc
+        );
+    }
+
+    return function;
+}
+
+/**
+ * @brief Runs the top level of a compiled program. Globals defined
+ *        by earlier runs stay defined.
+ * 
+ * @param[in] vm Pointer to the virtual machine struct.
+ * @param[in] chunk Pointer to the compiled program.
+ * @return value Returns the value of the program.
+ */
+value_T vm_run(vm_T* vm, chunk_T* chunk) {
+    vm_bind_globals(vm);
+
+    size_t entry_frames = vm->frames_size;
+    vm_frame_T* frame = vm_push_frame(vm, &chunk->functions[0], vm->stack_size);
+
+    // The state of the innermost frame lives in locals while it runs,
+    // and goes back to the frame when it calls.
+    const uint8_t* ip = frame->ip;
+    value_T* constants = chunk->constants;
+    chunk_call_cache_T* calls = chunk->call_caches;
+    value_T* slots = vm->stack + frame->base;
+    value_T* sp = slots;
+
+    #define READ_OPERAND() (ip += 4, chunk_read_operand(ip - 4))
+
+    // Operators on two integers or two doubles are applied in place,
+    // everything else goes through value_binary.
+    #define ARITHMETIC(overflow, operator) { \
+        value_T right = sp[-1]; \
+        value_T left = sp[-2]; \
+        int32_t number; \
+        if (value_is_int(left) && value_is_int(right) \
+                && !overflow(value_as_int(left), value_as_int(right), &number)) { \
+            sp--; \
+            sp[-1] = value_int(number); \
+            break; \
+        } \
+        if (value_is_double(left) && value_is_double(right)) { \
+            sp--; \
+            sp[-1] = value_double(value_as_double(left) operator value_as_double(right)); \
+            break; \
+        } \
+        goto binary; \
+    }
+
+    #define COMPARISON(operator) { \
+        value_T right = sp[-1]; \
+        value_T left = sp[-2]; \
+        if (value_is_int(left) && value_is_int(right)) { \
+            sp--; \
+            sp[-1] = value_bool(value_as_int(left) operator value_as_int(right)); \
+            break; \
+        } \
+        if (value_is_double(left) && value_is_double(right)) { \
+            sp--; \
+            sp[-1] = value_bool(value_as_double(left) operator value_as_double(right)); \
+            break; \
+        } \
+        goto binary; \
+    }
+
+    for (;;) {
+        switch (*ip++) {
+            case OP_CONSTANT: {
+                *sp++ = constants[READ_OPERAND()];
+                break;
+            }
+            case OP_NIL: {
+                *sp++ = VALUE_NIL;
+                break;
+            }
+            case OP_POP: {
+                sp--;
+                break;
+            }
+            case OP_GET_LOCAL: {
+                *sp++ = slots[READ_OPERAND()];
+                break;
+            }
+            case OP_GET_GLOBAL: {
+                uint32_t global = READ_OPERAND();
+                value_T value = vm->globals[global];
+
+                if (value == VALUE_UNDEFINED) {
+                    runtime_error(vm->runtime, "Undefined var `%s`", vm->runtime->globals.names[global]);
+                }
+
+                *sp++ = value;
+                break;
+            }
+            case OP_SET_GLOBAL: {
+                vm->globals[READ_OPERAND()] = *--sp;
+                break;
+            }
+            case OP_DEFINE_FN: {
+                uint32_t global = READ_OPERAND();
+                chunk_function_T* function = &chunk->functions[READ_OPERAND()];
+
+                if (vm->functions[global] != NULL && vm->functions[global] != function) {
+                    vm->functions_version += 1;
+                }
+
+                vm->functions[global] = function;
+                break;
+            }
+            case OP_CALL: {
+                uint32_t global = READ_OPERAND();
+                uint32_t argc = READ_OPERAND();
+                chunk_call_cache_T* cache = &calls[READ_OPERAND()];
+                chunk_function_T* function = cache->function;
+
+                if (cache->version != vm->functions_version) {
+                    function = vm_lookup_call(vm, global, argc);
+                    cache->function = function;
+                    cache->version = vm->functions_version;
+                }
+
+                vm->frames[vm->frames_size - 1].ip = ip;
+                frame = vm_push_frame(vm, function, (sp - vm->stack) - argc);
+
+                if (vm->runtime->profiler != NULL) {
+                    profiler_enter(vm->runtime->profiler, function, function->name);
+                }
+
+                ip = frame->ip;
+                constants = function->chunk->constants;
+                calls = function->chunk->call_caches;
+                slots = vm->stack + frame->base;
+                sp = slots + argc;
+                break;
+            }
+            case OP_TAIL_CALL: {
+                uint32_t global = READ_OPERAND();
+                uint32_t argc = READ_OPERAND();
+                chunk_call_cache_T* cache = &calls[READ_OPERAND()];
+                chunk_function_T* function = cache->function;
+
+                if (cache->version != vm->functions_version) {
+                    function = vm_lookup_call(vm, global, argc);
+                    cache->function = function;
+                    cache->version = vm->functions_version;
+                }
+
+                // The arguments replace those of the current call,
+                // whose frame now runs the called function.
+                frame = &vm->frames[vm->frames_size - 1];
+                size_t args = (sp - vm->stack) - argc;
+
+                vm_reserve_stack(vm, function, frame->base);
+                memmove(vm->stack + frame->base, vm->stack + args, argc * sizeof(value_T));
+
+                frame->function = function;
+                ip = function->chunk->code + function->entry;
+
+                if (vm->runtime->profiler != NULL) {
+                    profiler_tail(vm->runtime->profiler, function, function->name);
+                }
+
+                constants = function->chunk->constants;
+                calls = function->chunk->call_caches;
+                slots = vm->stack + frame->base;
+                sp = slots + argc;
+                break;
+            }
+            case OP_CALL_BUILTIN: {
+                builtin_T* builtin = &vm->runtime->builtins.entries[READ_OPERAND()];
+                uint32_t argc = READ_OPERAND();
+                sp -= argc;
+
+                *sp = builtin->fn(vm->runtime, sp, argc);
+                sp++;
+                break;
+            }
+            case OP_RETURN: {
+                value_T result = *--sp;
+                sp = vm->stack + vm->frames[--vm->frames_size].base;
+
+                if (vm->frames_size == entry_frames) {
+                    vm->stack_size = sp - vm->stack;
+                    return result;
+                }
+
+                if (vm->runtime->profiler != NULL) {
+                    profiler_exit(vm->runtime->profiler);
+                }
+
+                frame = &vm->frames[vm->frames_size - 1];
+                ip = frame->ip;
+                constants = frame->function->chunk->constants;
+                calls = frame->function->chunk->call_caches;
+                slots = vm->stack + frame->base;
+                *sp++ = result;
+                break;
+            }
+            case OP_NEGATE: {
+                value_T value = sp[-1];
+
+                if (value_is_int(value) && value_as_int(value) != INT32_MIN) {
+                    sp[-1] = value_int(-value_as_int(value));
+                    break;
+                }
+
+                value_status_T status = value_negate(value, &sp[-1]);
+
+                if (status != VALUE_OK) {
+                    runtime_error_operation(vm->runtime, "-", status);
+                }
+                break;
+            }
+            case OP_ADD: ARITHMETIC(__builtin_add_overflow, +)
+            case OP_SUB: ARITHMETIC(__builtin_sub_overflow, -)
+            case OP_MUL: ARITHMETIC(__builtin_mul_overflow, *)
+            case OP_LESS: COMPARISON(<)
+            case OP_GREATER: COMPARISON(>)
+            case OP_LESS_EQUAL: COMPARISON(<=)
+            case OP_GREATER_EQUAL: COMPARISON(>=)
+            case OP_DIV:
+            case OP_MOD:
+            case OP_EQUAL:
+            case OP_NOT_EQUAL:
+            binary: {
+                value_op_T op = ip[-1] - OP_ADD;
+                value_status_T status = value_binary(op, sp[-2], sp[-1], &sp[-2]);
+
+                if (status != VALUE_OK) {
+                    runtime_error_operation(vm->runtime, value_op_names[op], status);
+                }
+
+                sp--;
+                break;
+            }
+            default: {
+                runtime_error(vm->runtime, "Unknown opcode `%d`", ip[-1]);
+            }
+        }
+    }
+
+    #undef READ_OPERAND
+    #undef ARITHMETIC
+    #undef COMPARISON
+}